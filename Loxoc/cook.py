@@ -0,0 +1,66 @@
+"""
+Offline texture cooker.  Writes a ``.lxt`` file next to every image so the engine can load it without decoding.
+
+    python -m Loxoc.cook [--format bc1|bc3|bc5|rgba8] [--no-mips] [--force] paths...
+
+Directories are searched recursively.  Images whose cooked file is already up to date are skipped unless ``--force`` is given.
+"""
+import argparse
+import os
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from Loxoc.core import Texture, CookedFormat
+
+IMAGE_EXTENSIONS = {".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".gif", ".hdr", ".pic", ".pnm", ".ppm", ".pgm"}
+
+FORMATS = {
+    "rgba8": CookedFormat.RGBA8,
+    "bc1": CookedFormat.BC1,
+    "bc3": CookedFormat.BC3,
+    "bc5": CookedFormat.BC5,
+}
+
+def find_images(paths: list[str]) -> list[str]:
+    ret = []
+    for p in paths:
+        if os.path.isdir(p):
+            for root, _, files in os.walk(p):
+                ret.extend(os.path.join(root, f) for f in files if os.path.splitext(f)[1].lower() in IMAGE_EXTENSIONS)
+        else:
+            ret.append(p)
+    return ret
+
+def is_stale(image: str) -> bool:
+    cooked = os.path.splitext(image)[0] + ".lxt"
+    return not os.path.exists(cooked) or os.path.getmtime(cooked) < os.path.getmtime(image)
+
+def main(argv: list[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(prog="python -m Loxoc.cook", description="Cook images into .lxt textures with precomputed mip chains.")
+    parser.add_argument("paths", nargs="+", help="image files or directories")
+    parser.add_argument("--format", choices=FORMATS.keys(), default="bc1", help="bc1 for opaque color, bc3 for color with alpha, bc5 for normal maps")
+    parser.add_argument("--no-mips", action="store_true", help="only store the full size level")
+    parser.add_argument("--force", action="store_true", help="cook even if the .lxt is newer than the image")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1)
+    args = parser.parse_args(argv)
+
+    images = [img for img in find_images(args.paths) if args.force or is_stale(img)]
+    format = FORMATS[args.format]
+    failed = 0
+
+    def cook(image: str) -> None:
+        nonlocal failed
+        try:
+            out = Texture.cook(image, None, format, not args.no_mips)
+            print(f"{image} -> {out}")
+        except RuntimeError as e:
+            failed += 1
+            print(f"{image}: {e}", file=sys.stderr)
+
+    with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        list(pool.map(cook, images))
+
+    print(f"cooked {len(images) - failed} of {len(images)} textures")
+    return 1 if failed else 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -3,6 +3,7 @@ from libcpp.vector cimport vector
 from libcpp.string cimport string
 from libcpp.map cimport map
 from libcpp.pair cimport pair
+from libc.stdint cimport uint64_t
 
 cdef extern from "<variant>" namespace "std" nogil:
     cdef cppclass variant:
@@ -46,7 +47,7 @@ cdef extern from "../src/RC.h":
         RC() except +
         RC(T data) except +
         T inc()
-        void dec()
+        int dec()
         T data
         int refcount
 
@@ -57,6 +58,23 @@ cdef extern from "../src/util.h":
 
 cpdef void set_mod_path(str path)
 
+cdef extern from "../src/CookedTexture.h":
+    cpdef enum class CookedFormat:
+        RGBA8,
+        BC1,
+        BC3,
+        BC5
+
+    cdef cppclass cooked_texture:
+        @staticmethod
+        void cook(const string& source_path, const string& out_path, CookedFormat format, bint generate_mips) except + nogil
+        @staticmethod
+        string cooked_path(const string& source_path)
+        @staticmethod
+        void set_prefer_cooked(bint value)
+        @staticmethod
+        bint is_prefer_cooked()
+
 cdef extern from "../src/Texture.h":
     cpdef enum class TextureFiltering:
         NEAREST,
@@ -72,11 +90,118 @@ cdef extern from "../src/Texture.h":
         texture() except +
         texture(string file_path, TextureWraping wrap, TextureFiltering filtering) except +
         int width, height, number_of_channels
+        string cooked_path
+        int resident_level, wanted_level
+        size_t resident_bytes
+        bint is_streamed()
+        int mip_levels()
         void bind()
 
 cdef class Texture:
     cdef RC[texture*]* c_class
 
+cdef extern from "../src/TextureStreamer.h":
+    cdef struct texture_stream_stats:
+        size_t budget_bytes, resident_bytes, textures, fully_resident, pending, raises, evictions
+
+    cdef cppclass texture_streamer:
+        @staticmethod
+        void set_enabled(bint value)
+        @staticmethod
+        bint is_enabled()
+        @staticmethod
+        void set_budget(size_t bytes)
+        @staticmethod
+        size_t get_budget()
+        @staticmethod
+        texture_stream_stats get_stats()
+
+cdef class TextureStreaming:
+    pass
+
+cdef extern from "../src/AnimationLod.h":
+    cdef struct animation_lod_stats:
+        size_t objects, offscreen, reduced_rate, detail_culled, channels_evaluated, channels_saved
+
+    cdef cppclass animation_lod:
+        @staticmethod
+        void set_enabled(bint value)
+        @staticmethod
+        bint is_enabled()
+        @staticmethod
+        void set_rate_thresholds(float half, float quarter, float eighth)
+        @staticmethod
+        void set_detail_threshold(float px)
+        @staticmethod
+        void set_pause_offscreen(bint value)
+        @staticmethod
+        animation_lod_stats get_stats()
+
+cdef class AnimationLOD:
+    pass
+
+cdef extern from "../src/ClipCompression.h":
+    cdef struct clip_compression_stats:
+        size_t channels, constant_channels, source_keys, kept_keys, source_bytes, compressed_bytes
+        float max_position_error, max_rotation_error, max_scale_error
+
+    cdef cppclass clip_compression:
+        @staticmethod
+        void set_tolerances(float position, float rotation, float scale)
+        @staticmethod
+        clip_compression_stats get_stats()
+        @staticmethod
+        void reset_stats()
+
+cdef class ClipCompression:
+    pass
+
+cdef extern from "../src/StreamBuffer.h":
+    cdef struct stream_buffer_stats:
+        size_t frame_bytes, peak_frame_bytes, frame_capacity, stalls, grows
+        bint persistent
+
+    cdef cppclass stream_buffer:
+        stream_buffer_stats get_stats()
+        @staticmethod
+        void set_allow_persistent(bint value)
+        @staticmethod
+        stream_buffer* get_global()
+
+cdef class StreamBuffer:
+    pass
+
+cdef extern from "../src/ParticleProfiler.h":
+    cdef struct particle_stats:
+        size_t emitters, particles, culled_emitters, skipped_emitters, reduced_emitters, simulated_particles, drawn_particles
+        size_t sorted_emitters, sorted_particles, reused_orders, radix_sorts
+        double sort_ms
+        size_t collision_emitters, collisions
+        double collision_ms
+
+    cdef cppclass particle_profiler:
+        @staticmethod
+        particle_stats get_stats()
+
+cdef class ParticleProfiler:
+    pass
+
+cdef extern from "../src/ParticleLod.h":
+    cdef cppclass particle_lod:
+        @staticmethod
+        void set_enabled(bint value)
+        @staticmethod
+        bint is_enabled()
+        @staticmethod
+        void set_distance(float full_rate, float minimum)
+        @staticmethod
+        void set_cull_offscreen(bint value)
+        @staticmethod
+        void set_coarse_interval(int frames)
+
+cdef class ParticleLOD:
+    pass
+
 cpdef Texture Texture_from_file(str file_path, TextureWraping wrap, TextureFiltering filtering)
 
 cdef Texture texture_from_cpp(RC[texture*]* cppinst)
@@ -104,6 +229,69 @@ cdef class Shader:
 
 
 
+cdef extern from "../src/ResourceCache.h":
+    cdef struct resource_stats:
+        size_t shader_file_reads
+        size_t shader_hits, shader_misses
+        size_t program_hits, program_links
+        size_t program_binary_loads
+        size_t texture_hits, texture_decodes
+        size_t texture_bytes
+        size_t programs, textures
+        double last_import_ms
+        double last_texture_decode_ms
+
+    cdef cppclass resource_cache:
+        @staticmethod
+        RC[shader*]* get_shader(const string& file_path, ShaderType type) except +
+        @staticmethod
+        RC[texture*]* get_texture(const string& file_path, TextureWraping wrap, TextureFiltering filtering) except +
+        @staticmethod
+        size_t purge_unused()
+        @staticmethod
+        void clear()
+        @staticmethod
+        void clear_textures()
+        @staticmethod
+        resource_stats get_stats()
+        @staticmethod
+        void reset_stats()
+        @staticmethod
+        void set_enabled(bint value)
+        @staticmethod
+        bint is_enabled()
+        @staticmethod
+        void set_parallel_decode(bint value)
+        @staticmethod
+        bint is_parallel_decode()
+
+cdef class ResourceCache:
+    pass
+
+cdef extern from "../src/ProgramCache.h":
+    cdef struct program_cache_stats:
+        size_t hits, misses, rejected, stored
+        bint unsupported
+
+    cdef cppclass program_binary_cache:
+        @staticmethod
+        void set_directory(const string& path)
+        @staticmethod
+        string get_directory()
+        @staticmethod
+        void set_enabled(bint value)
+        @staticmethod
+        bint is_enabled()
+        @staticmethod
+        size_t clear()
+        @staticmethod
+        program_cache_stats get_stats()
+        @staticmethod
+        void reset_stats()
+
+cdef class ProgramCache:
+    pass
+
 cdef extern from "../src/Material.h":
 
     ctypedef variant uniform_type
@@ -790,9 +978,12 @@ cdef extern from "../src/Model.h":
         model() except +
         model(RC[mesh_dict*]* mesh_data, bint animated) except +
         void play_animation(const string& animation) except +
+        void bake_animation(const string& animation, float fps) except +
         RC[mesh_dict*]* mesh_data
         bint animated
+        bint baked
         bint use_default_material_properties
+        bint loaded
 
 cdef class Model:
     cdef:
@@ -800,12 +991,37 @@ cdef class Model:
         MeshDict _mesh_data
 
     cpdef void play_animation(self, str animation)
+    cpdef void bake_animation(self, str animation, float fps=*)
 
     @staticmethod
     cdef Model from_cpp(model cppinst)
     @staticmethod
     cdef Model from_cpp_ptr(RC[model*]* cppinst)
 
+cdef extern from "../src/AsyncLoader.h":
+    cpdef enum class LoadState:
+        PENDING,
+        IMPORTING,
+        UPLOADING,
+        READY,
+        FAILED
+
+    cdef cppclass model_loader:
+        model_loader(string file_path, bint animated) except +
+        LoadState get_state()
+        string get_error()
+        bint is_ready()
+        void finish() except +
+        string file_path
+        RC[model*]* result
+
+cdef class ModelLoader:
+    cdef:
+        model_loader* c_class
+        Model _model
+
+    cpdef Model finish(self)
+
 
 
 cdef extern from "../src/Object3d.h":
@@ -820,8 +1036,12 @@ cdef extern from "../src/Object3d.h":
         vec3* scale
         RC[material*]* mat
         vector[RC[collider*]*] colliders
+        float baked_time_offset
+        bint refit_colliders_on_update
 
         void render(camera& camera, window* window)
+
+        void refit_colliders() except +
         
         vector[vec3] get_translation(vector[vec3] vertexes)
 
@@ -829,6 +1049,8 @@ cdef extern from "../src/Object3d.h":
 
         void set_uniform(string name, uniform_type value)
 
+        void play_animation(const string& name) except +
+
         inline bint check_collision_point(vec3 point)
 
         inline bint check_collision_object(object3d* obj)
@@ -958,9 +1180,19 @@ cdef extern from "../src/Text.h":
         font() except +
         font(const string& font_path, int font_size) except +
 
+    cdef struct text_stats:
+        size_t texts, glyphs, draws, relayouts, uploaded_bytes
+
+    cdef cppclass text_batcher:
+        @staticmethod
+        text_stats get_stats()
+
 cdef class Font:
     cdef font* c_class
 
+cdef class TextProfiler:
+    pass
+
 cdef class Text:
     cdef:
         text* c_class
@@ -1019,6 +1251,9 @@ cdef extern from "../src/Window.h":
 
         event current_event
         double deltatime
+        double upload_budget
+        bint parallel_animation
+        bint parallel_particles
         bint fullscreen
         long long time_ns
         long long time
@@ -1547,25 +1782,26 @@ cdef class SkyBox:
         Material _material
         skybox* c_class
 
-cdef extern from "../src/Emitter.h":
-    cdef cppclass particle:
-        particle() except +
-        particle(vec3 position, vec2 scale, vec3 velocity, vec4 color, float life) except +
-
-        vec3 position, velocity
-        vec2 scale
-        vec4 color
-        float life
-        float starting_life
+cdef extern from "../src/ParticleSimulation.h":
+    cpdef enum class CollisionResponse:
+        NONE,
+        BOUNCE,
+        STICK,
+        KILL
 
+cdef extern from "../src/Emitter.h":
     cdef cppclass emitter:
         emitter(vec3* position, quaternion* direction, vec2* scale_min, vec2* scale_max, size_t rate, float decay_rate, float spread, float velocity_decay, float start_velocity_min, float start_velocity_max, float start_lifetime_min, float start_lifetime_max, vec4* color_min, vec4* color_max, RC[material*]* material) except +
 
         inline void start()
         inline void stop()
         inline void render(const camera & cam)
-        
-        vector[particle] particles
+        uint64_t get_seed()
+        void set_seed(uint64_t seed)
+        bint draws_instanced()
+        void add_collision_plane(const vec3& point, const vec3& normal)
+        void add_collision_sphere(const vec3& center, float radius)
+        void clear_collision_shapes()
 
         vec3* position
         quaternion* direction
@@ -1578,6 +1814,10 @@ cdef extern from "../src/Emitter.h":
         vec4* color_max
         RC[material*]* material
         bint emitting
+        bint depth_sort
+        CollisionResponse collision_response
+        float restitution
+        bint collide_colliders
 
 cdef class Emitter:
     cdef:
@@ -220,7 +220,7 @@ class Material:
 
     You may supply your own :class:`Shader` s to customize how Objects are rendered.
     """
-    def __init__(self, vertex:Shader|None = None, fragment:Shader|None = None, geometry:Shader|None = None, compute:Shader|None = None, animated:bool = False) -> None:...
+    def __init__(self, vertex:Shader|None = None, fragment:Shader|None = None, geometry:Shader|None = None, compute:Shader|None = None, animated:bool = False, baked:bool = False) -> None:...
 
     def set_uniform(self, name:str, value:UniformValueType) ->None:
         """
@@ -277,6 +277,18 @@ class Model:
         Returns the :class:`Model` instance created from the provided file.  If the 3D asset contains animations, set `animated` to `True` .
         """
 
+    @staticmethod
+    def from_file_async( file_path:str, animated:bool = False) -> ModelLoader:
+        """
+        Starts loading the provided file in the background and returns a :class:`ModelLoader` right away.  The import and image decoding happen on worker threads and the GPU upload is spread over the following :meth:`Window.update` calls.  See :attr:`Window.upload_budget` .
+        """
+
+    @property
+    def loaded(self) -> bool:
+        """
+        ``False`` while the :class:`Model` is still being loaded by a :class:`ModelLoader` .  :class:`Object3D` s using the model are not rendered untill it is ``True``.
+        """
+
     @property
     def use_default_material_properties(self) -> bool:
         """
@@ -293,7 +305,21 @@ class Model:
 
     def play_animation(self, animation:str) -> None:
         """
-        Plays the specified animation.
+        Plays the specified animation on every :class:`Object3D` of this model that has not picked its own with :meth:`Object3D.play_animation` .
+        Each object keeps its own clock and pose, the animation data itself is shared.
+        """
+
+    def bake_animation(self, animation:str, fps:float = 30.0) -> None:
+        """
+        Skins the model with the specified animation ``fps`` times per second and stores the results in textures.
+        :class:`Object3D` s of the model then play the baked animation on the GPU instead of evaluating their skeleton, which suits large crowds.
+        Objects need a :class:`Material` created with ``baked=True`` , which is the default for objects created after baking.  Use :attr:`Object3D.baked_time_offset` to keep instances out of step.
+        """
+
+    @property
+    def baked(self) -> bool:
+        """
+        Whether :meth:`Model.bake_animation` was called on this model.
         """
     
 
@@ -321,6 +347,79 @@ class Model:
         Whether or not the model has animations.  If it does set this to true.
         """
 
+class LoadState(Enum):
+    """
+    The progress of a :class:`ModelLoader` .
+
+    .. #pragma: ignore_inheritance
+    """
+    PENDING: 'LoadState'
+    IMPORTING: 'LoadState'
+    UPLOADING: 'LoadState'
+    READY: 'LoadState'
+    FAILED: 'LoadState'
+
+class CollisionResponse(Enum):
+    """
+    What an :class:`Emitter`\'s particles do when they hit a collision shape.  See :attr:`Emitter.collision_response` .
+
+    .. #pragma: ignore_inheritance
+    """
+    NONE: 'CollisionResponse'
+    BOUNCE: 'CollisionResponse'
+    STICK: 'CollisionResponse'
+    KILL: 'CollisionResponse'
+
+class ModelLoader:
+    """
+    A handle to a :class:`Model` being loaded in the background.  Created with :meth:`Model.from_file_async` .
+    """
+
+    def __init__(self, file_path:str, animated:bool = False) -> None:
+        ...
+
+    @property
+    def model(self) -> Model:
+        """
+        The :class:`Model` being loaded.  It can be given to :class:`Object3D` s right away and becomes visible once the load is complete.
+        Do not read or change its :class:`MeshDict` untill :attr:`ModelLoader.ready` is ``True``.
+        """
+
+    @property
+    def state(self) -> LoadState:
+        """
+        The current :class:`LoadState` of the load.
+        """
+
+    @property
+    def ready(self) -> bool:
+        """
+        ``True`` once the :class:`Model` is uploaded and renderable.
+        """
+
+    @property
+    def failed(self) -> bool:
+        """
+        ``True`` if the import failed.  See :attr:`ModelLoader.error` .
+        """
+
+    @property
+    def error(self) -> str:
+        """
+        The error message of a failed import.
+        """
+
+    @property
+    def file_path(self) -> str:
+        """
+        The file being loaded.
+        """
+
+    def finish(self) -> Model:
+        """
+        Blocks untill the :class:`Model` is ready and returns it, uploading any remaining GPU data immediately.  Raises an exception if the import failed.
+        """
+
 class Object3D:
     """
     This class is your 3D game object.
@@ -387,7 +486,38 @@ class Object3D:
 
     def play_animation(self, animation_name: str) -> None:
         """
-        Plays the specified animation by name of the model.
+        Plays the specified animation by name of the model on this object only, from the beginning.
+        Other objects sharing the model are not affected.
+        """
+
+    @property
+    def baked_time_offset(self) -> float:
+        """
+        Seconds added to this object's clock when playing its model's baked animation.  See :meth:`Model.bake_animation` .
+        """
+
+    @baked_time_offset.setter
+    def baked_time_offset(self, value:float) -> None:
+        """
+        Seconds added to this object's clock when playing its model's baked animation.  See :meth:`Model.bake_animation` .
+        """
+
+    def refit_colliders(self) -> None:
+        """
+        Skins the model with the object's current animation pose on the CPU and fits the box and convex colliders made from this object to it.
+        Does not need a GPU, so it can be used by headless simulations.  Does nothing while no animation is playing on the object.
+        """
+
+    @property
+    def refit_colliders_on_update(self) -> bool:
+        """
+        When set, :meth:`Object3D.refit_colliders` is called after every animation update.  Rebuilding convex colliders every frame is expensive.  Defaults to ``False`` .
+        """
+
+    @refit_colliders_on_update.setter
+    def refit_colliders_on_update(self, value:bool) -> None:
+        """
+        When set, :meth:`Object3D.refit_colliders` is called after every animation update.  Rebuilding convex colliders every frame is expensive.  Defaults to ``False`` .
         """
 
     @property
@@ -439,7 +569,122 @@ class Shader:
     def __init__(self, source:str, shader_type:ShaderType) -> None:...
 
     @classmethod
-    def from_file(cls, filepath:str, type:ShaderType) -> Shader:...
+    def from_file(cls, filepath:str, type:ShaderType) -> Shader:
+        """
+        Loads a shader from a glsl file.  Files with the same source are shared through the :class:`ResourceCache` .
+        """
+
+class ResourceCache:
+    """
+    Shares shader sources, linked shader programs and textures between every :class:`Material` and :class:`Mesh` .
+    Imported models reuse one program per unique set of shader sources and one texture per file and sampler setting.
+    """
+
+    @staticmethod
+    def stats() -> dict:
+        """
+        Returns the cache counters: ``shader_file_reads``, ``shader_hits``, ``shader_misses``, ``program_hits``, ``program_links``, ``program_binary_loads`` (programs restored by the :class:`ProgramCache` ), ``texture_hits``, ``texture_decodes``,
+        ``texture_bytes`` (estimated texture memory uploaded, including mipmaps), ``programs``, ``textures``, ``last_import_ms`` (the wall time of the last model import) and ``last_texture_decode_ms`` (the part of it spent decoding images).
+        """
+
+    @staticmethod
+    def reset_stats() -> None:
+        """
+        Zeros the counters returned by :meth:`ResourceCache.stats` .
+        """
+
+    @staticmethod
+    def set_enabled(value:bool) -> None:
+        """
+        Disabling the cache makes every load create its own resources.  Useful for comparing load times and memory use with and without sharing.
+        """
+
+    @staticmethod
+    def is_enabled() -> bool:
+        """
+        Whether the cache is enabled.  Defaults to ``True``.
+        """
+
+    @staticmethod
+    def set_parallel_decode(value:bool) -> None:
+        """
+        When enabled, model imports decode all of their textures at once across worker threads before building meshes.
+        Disable it to decode them one after another on the importing thread.  Only applies while the cache is enabled.
+        """
+
+    @staticmethod
+    def is_parallel_decode() -> bool:
+        """
+        Whether textures are decoded in parallel during imports.  Defaults to ``True``.
+        """
+
+    @staticmethod
+    def purge_unused() -> int:
+        """
+        Frees cached shaders and textures that are no longer used by anything, returns how many were freed.
+        """
+
+    @staticmethod
+    def clear() -> None:
+        """
+        Forgets every cached resource.  Resources still in use stay alive.
+        """
+
+    @staticmethod
+    def clear_textures() -> None:
+        """
+        Forgets every cached texture so the next import decodes its images again, shaders and programs stay cached.  Textures still in use stay alive.
+        """
+
+class ProgramCache:
+    """
+    Saves linked shader programs to disk so later runs can skip compiling and linking them.
+    Entries are tied to the gpu and driver version, when the driver refuses a saved program it is deleted and linked again from source.
+    Does nothing on drivers that expose no program binary formats.
+    """
+
+    @staticmethod
+    def stats() -> dict:
+        """
+        Returns the counters ``hits``, ``misses``, ``rejected`` (saved programs the driver refused), ``stored`` and ``unsupported`` (``True`` when the driver can't save programs).
+        """
+
+    @staticmethod
+    def reset_stats() -> None:
+        """
+        Zeros the counters returned by :meth:`ProgramCache.stats` .
+        """
+
+    @staticmethod
+    def set_directory(path:str) -> None:
+        """
+        Sets the directory programs are saved in.  Defaults to the ``LOXOC_PROGRAM_CACHE`` environment variable, or ``loxoc_program_cache`` in the system temp directory.
+        Set this before any :class:`Material` is created.
+        """
+
+    @staticmethod
+    def get_directory() -> str:
+        """
+        The directory programs are saved in.
+        """
+
+    @staticmethod
+    def set_enabled(value:bool) -> None:
+        """
+        Enables or disables loading and saving programs.  Defaults to ``True``.
+        """
+
+    @staticmethod
+    def is_enabled() -> bool:
+        """
+        Whether the program cache is enabled.
+        """
+
+    @staticmethod
+    def clear() -> int:
+        """
+        Deletes every saved program from the cache directory, returns how many files were removed.
+        """
 
 class Vec4:
     """
@@ -851,6 +1096,46 @@ class Window:
         The current deltatime for the window.
         """
 
+    @property
+    def upload_budget(self) -> float:
+        """
+        The time in milliseconds that each :meth:`Window.update` may spend uploading :class:`Model` s loaded with :meth:`Model.from_file_async` to the GPU.  Defaults to ``2.0``.
+        The budget is checked between uploads, each one being a single mesh or texture, and at least one upload runs every update so loading always makes progress.
+        A frame can therefore go over the budget by the time of its largest upload, a big texture with its whole mip chain for example.  A negative budget uploads everything at once.
+        """
+
+    @upload_budget.setter
+    def upload_budget(self, value:float) -> None:
+        """
+        The time in milliseconds that each :meth:`Window.update` may spend uploading :class:`Model` s loaded with :meth:`Model.from_file_async` to the GPU.  Defaults to ``2.0``.
+        The budget is checked between uploads, each one being a single mesh or texture, and at least one upload runs every update so loading always makes progress.
+        A frame can therefore go over the budget by the time of its largest upload, a big texture with its whole mip chain for example.  A negative budget uploads everything at once.
+        """
+
+    @property
+    def parallel_animation(self) -> bool:
+        """
+        When set, :meth:`Window.update` evaluates the poses of all animated :class:`Object3D` s across worker threads before rendering.  Defaults to ``True``.
+        """
+
+    @parallel_animation.setter
+    def parallel_animation(self, value:bool) -> None:
+        """
+        When set, :meth:`Window.update` evaluates the poses of all animated :class:`Object3D` s across worker threads before rendering.  Defaults to ``True``.
+        """
+
+    @property
+    def parallel_particles(self) -> bool:
+        """
+        When set, :meth:`Window.update` simulates every emitting :class:`Emitter` across worker threads before rendering, splitting large emitters into chunks.  Defaults to ``True``.
+        """
+
+    @parallel_particles.setter
+    def parallel_particles(self, value:bool) -> None:
+        """
+        When set, :meth:`Window.update` simulates every emitting :class:`Emitter` across worker threads before rendering, splitting large emitters into chunks.  Defaults to ``True``.
+        """
+
     @property
     def dt(self) -> float:
         """
@@ -1543,6 +1828,29 @@ class TextureWraping(Enum):
     CLAMP_TO_EDGE: 'TextureWraping'
     CLAMP_TO_BORDER: 'TextureWraping'
 
+class CookedFormat(Enum):
+    """
+    The pixel format of a cooked texture, see :meth:`Texture.cook` .
+
+    .. #pragma: ignore_inheritance
+    """
+    RGBA8: 'CookedFormat'
+    """
+    Uncompressed, 4 bytes per pixel.
+    """
+    BC1: 'CookedFormat'
+    """
+    Block compressed opaque color, 8 times smaller than ``RGBA8`` .  Needs ``EXT_texture_compression_s3tc`` .
+    """
+    BC3: 'CookedFormat'
+    """
+    Block compressed color with alpha, 4 times smaller than ``RGBA8`` .  Needs ``EXT_texture_compression_s3tc`` .
+    """
+    BC5: 'CookedFormat'
+    """
+    Block compressed red and green channels, for normal maps and other two channel data.
+    """
+
 class Texture:
     """
     A texture for a :class:`Mesh` or :class:`Sprite` .
@@ -1551,6 +1859,243 @@ class Texture:
     def from_file(cls, file_path:str, wrap:TextureWraping = TextureWraping.REPEAT, filtering:TextureFiltering = TextureFiltering.LINEAR) -> Texture:
         """
         Create a :class:`Texture` from the specified file.
+        If a cooked ``.lxt`` file with the same name exists next to it (see :meth:`Texture.cook`) and is at least as new, the cooked file is loaded instead.
+        """
+
+    @staticmethod
+    def cook(source_path:str, out_path:str = None, format:CookedFormat = CookedFormat.BC1, generate_mips:bool = True) -> str:
+        """
+        Cooks an image offline into a ``.lxt`` file holding its whole mip chain, optionally block compressed.
+        Cooked files load without decoding or generating mipmaps at runtime.  ``out_path`` defaults to the source path with a ``.lxt`` extension, which is where
+        :meth:`Texture.from_file` , model imports and :class:`CubeMap` look for it.  Returns the path written.  Does not need a :class:`Window` .
+
+        For whole asset folders use ``python -m Loxoc.cook`` .
+        """
+
+    @staticmethod
+    def set_prefer_cooked(value:bool) -> None:
+        """
+        When ``False`` , cooked files are ignored and every texture is decoded from its source image.  Defaults to ``True`` .
+        """
+
+    @staticmethod
+    def is_prefer_cooked() -> bool:
+        """
+        Whether cooked textures are loaded when available.
+        """
+
+    @property
+    def cooked(self) -> bool:
+        """
+        Whether this texture was loaded from a cooked file.
+        """
+
+    @property
+    def streamed(self) -> bool:
+        """
+        Whether this texture's mip levels are managed by :class:`TextureStreaming` .
+        """
+
+    @property
+    def mip_levels(self) -> int:
+        """
+        The number of mip levels the texture has.  ``1`` when it is not streamed.
+        """
+
+    @property
+    def resident_level(self) -> int:
+        """
+        The finest mip level currently in video memory, ``0`` being full resolution.
+        """
+
+    @property
+    def wanted_level(self) -> int:
+        """
+        The mip level the :class:`TextureStreaming` manager wants resident, based on how large the texture was last drawn.
+        """
+
+    @property
+    def resident_bytes(self) -> int:
+        """
+        Video memory used by the resident mip levels.  ``0`` when it is not streamed.
+        """
+
+class TextureStreaming:
+    """
+    Streams texture mip levels in and out of video memory within a budget.
+    Streamed textures are first uploaded at a small size and raised to the level that matches how large their :class:`Mesh` es appear on screen.  Sprite and particle textures are raised to full resolution once drawn, and textures that are never drawn keep their starting size.
+    When the budget is exceeded, the textures drawn least recently lose their finest levels.
+    Textures only stream if streaming was enabled before they were loaded, and are larger than the starting size.  They keep their full mip chain in system memory (cooked textures stay memory mapped), built while the image is decoded.
+    """
+
+    @staticmethod
+    def set_enabled(value:bool) -> None:
+        """
+        Enables streaming for textures loaded from now on.  Defaults to ``False`` .
+        """
+
+    @staticmethod
+    def is_enabled() -> bool:
+        """
+        Whether texture streaming is enabled.
+        """
+
+    @staticmethod
+    def set_budget(bytes:int) -> None:
+        """
+        Sets the video memory budget for streamed textures in bytes.  Defaults to 512 MiB.
+        """
+
+    @staticmethod
+    def get_budget() -> int:
+        """
+        The video memory budget for streamed textures in bytes.
+        """
+
+    @staticmethod
+    def stats() -> dict:
+        """
+        Returns ``budget_bytes``, ``resident_bytes``, ``textures`` (how many are streamed), ``fully_resident``, ``pending`` (textures waiting for finer levels),
+        and the total ``raises`` and ``evictions`` made so far.
+        """
+
+class AnimationLOD:
+    """
+    Lowers the cost of animating :class:`Object3D` s that are small on screen or out of view.
+    Small objects evaluate their pose every 2nd, 4th or 8th frame and blend between poses in between, and very small ones hold their finger and face bones in the bind pose.
+    Objects outside the camera's view only advance their animation clock.
+    """
+
+    @staticmethod
+    def set_enabled(value:bool) -> None:
+        """
+        Enables animation level of detail.  Defaults to ``True`` .
+        """
+
+    @staticmethod
+    def is_enabled() -> bool:
+        """
+        Whether animation level of detail is enabled.
+        """
+
+    @staticmethod
+    def set_rate_thresholds(half:float, quarter:float, eighth:float) -> None:
+        """
+        Sets the on screen sizes in pixels below which objects update at half, a quarter and an eighth of the frame rate.  Defaults to ``200``, ``100`` and ``50`` .
+        """
+
+    @staticmethod
+    def set_detail_threshold(px:float) -> None:
+        """
+        Sets the on screen size in pixels below which finger, face and other small bones stop animating.  Defaults to ``150`` .
+        """
+
+    @staticmethod
+    def set_pause_offscreen(value:bool) -> None:
+        """
+        When set, objects outside the view pause their animation instead of only advancing its clock.  Defaults to ``False`` .
+        """
+
+    @staticmethod
+    def stats() -> dict:
+        """
+        Returns counters for the last frame: ``objects`` animated, ``offscreen``, ``reduced_rate``, ``detail_culled``,
+        and the keyframe channels ``channels_evaluated`` and ``channels_saved`` (skipped by level of detail).
+        """
+
+class ClipCompression:
+    """
+    Animations are compressed when they are imported.  Keys that interpolating their neighbours reproduces closely enough are removed,
+    channels that never move keep a single key, rotations are packed into 48 bits and positions and scales into 16 bits per axis.
+    """
+
+    @staticmethod
+    def set_tolerances(position:float, rotation:float, scale:float) -> None:
+        """
+        Sets the largest error a removed key may have, in model units, radians and scale factor.  Applies to animations imported afterwards.  Defaults to ``0.0001`` each.
+        """
+
+    @staticmethod
+    def stats() -> dict:
+        """
+        Returns totals over every animation imported so far: ``channels``, ``constant_channels``, ``source_keys``, ``kept_keys``, ``source_bytes``, ``compressed_bytes`` and their ``ratio``,
+        and the largest differences between a source key and the compressed animation, ``max_position_error``, ``max_rotation_error`` (radians) and ``max_scale_error``.
+        """
+
+    @staticmethod
+    def reset_stats() -> None:
+        """
+        Resets the totals returned by :meth:`ClipCompression.stats` .
+        """
+
+class StreamBuffer:
+    """
+    Particles and debug lines write their vertex data for each frame into a shared ring buffer instead of re-uploading their own buffers.
+    The ring holds three frames, so the cpu only waits on the gpu when it falls three frames behind.
+    """
+
+    @staticmethod
+    def set_allow_persistent(value:bool) -> None:
+        """
+        Whether the ring may be persistently mapped when the driver supports ``GL_ARB_buffer_storage``.  When ``False`` each write is mapped unsynchronized instead.
+        Only takes effect if called before anything has been drawn.  Defaults to ``True``.
+        """
+
+    @staticmethod
+    def stats() -> dict:
+        """
+        Returns ``frame_bytes`` written in the last frame, the most written in any frame ``peak_frame_bytes``, the ``frame_capacity`` of each of the three frames,
+        the number of frames that had to wait for the gpu ``stalls``, the number of times the ring ``grows`` to fit a frame and ``persistent``, whether it is mapped once for good.
+        """
+
+class ParticleProfiler:
+    """
+    Numbers on the particle simulation of the last :meth:`Window.update` .
+    """
+
+    @staticmethod
+    def stats() -> dict:
+        """
+        Returns the ``emitters`` emitting and their ``particles``, how many of them :class:`ParticleLOD` found out of view (``culled_emitters``), didn't simulate this frame (``skipped_emitters``)
+        or thinned out for their distance (``reduced_emitters``), the ``simulated_particles`` and ``drawn_particles``, the ``sorted_emitters`` with :attr:`Emitter.depth_sort` on and their ``sorted_particles``,
+        how many of those kept last frame's order (``reused_orders``) or were radix sorted again (``radix_sorts``), and the time spent sorting ``sort_ms`` summed over the worker threads.
+        Then the ``collision_emitters`` colliding their particles, the ``collisions`` (particles that hit something) and ``collision_ms``, the time those emitters' update took with collision (it runs in the same pass), also summed over the worker threads.
+        """
+
+class ParticleLOD:
+    """
+    Level of detail for :class:`Emitter`\s, on by default.  Emitters whose particles are out of the camera's view aren't drawn and are simulated less often,
+    and emitters far from the camera keep fewer of their particles alive.
+    """
+
+    @staticmethod
+    def set_enabled(value:bool) -> None:
+        """
+        Turns the level of detail on or off.  When off every emitter is simulated and drawn in full.
+        """
+
+    @staticmethod
+    def is_enabled() -> bool:
+        """
+        Whether the level of detail is on.
+        """
+
+    @staticmethod
+    def set_distance(full_rate:float, minimum:float) -> None:
+        """
+        Emitters closer than ``full_rate`` to the camera keep all of their particles.  Past it the share falls off with the distance, but never below ``minimum`` (0 to 1).  Defaults to 30 and 0.1.
+        """
+
+    @staticmethod
+    def set_cull_offscreen(value:bool) -> None:
+        """
+        Whether emitters out of view are skipped when drawing.  Defaults to True.
+        """
+
+    @staticmethod
+    def set_coarse_interval(frames:int) -> None:
+        """
+        Emitters out of view are only simulated every ``frames`` frames, catching up on the time they skipped.  0 pauses them untill they are back in view.  Defaults to 4.
         """
 
 class Sprite:
@@ -2687,9 +3232,23 @@ class Font:
     def __init__(self, font_path:str, font_size:int = 48) -> None:
         ...
 
+class TextProfiler:
+    """
+    Numbers on the text drawn in the last :meth:`Window.update` .
+    """
+
+    @staticmethod
+    def stats() -> dict:
+        """
+        Returns the ``texts`` and ``glyphs`` drawn and the ``draws`` it took, one for each :class:`Font` and :class:`Material` in use,
+        and the texts laid out again because they changed (``relayouts``) with the ``uploaded_bytes`` of vertex data it took.  Unchanged text is neither laid out nor uploaded.
+        """
+
 class Text:
     """
     Renders the specified Text to the screen with the specified :class:`Font` .
+    The texts added to a :class:`Window` are drawn together, one draw call for all the texts sharing a :class:`Font` and :class:`Material` .
+    A text is only laid out and uploaded again when its text, font, position, scale, rotation or color changes, static labels just cost their share of the draw.
     """
     def __init__(self, text_string:str, color:Vec4, position:Vec2, scale:Vec2 = Vec2(1.0, 1.0), rotation:float = 0, font:Font|None = None, material:Material|None = None) -> None:
         ...
@@ -2697,13 +3256,13 @@ class Text:
     @property
     def rotation(self) -> float:
         """
-        The rotation of the text.
+        The rotation of the text in radians, counter clockwise around its :attr:`Text.position` .
         """
 
     @rotation.setter
     def rotation(self, value:float):
         """
-        The rotation of the text.
+        The rotation of the text in radians, counter clockwise around its :attr:`Text.position` .
         """
 
     @property
@@ -2745,13 +3304,15 @@ class Text:
     @property
     def material(self) -> Material:
         """
-        The :class:`Material` of the text.
+        The :class:`Material` of the text.  Texts made without one share the default text material.
+        The text's color is passed to the vertex shader as the ``vertex_color`` attribute at location 1, the ``text_color`` uniform is left white.
         """
 
     @material.setter
     def material(self, value:Material):
         """
-        The :class:`Material` of the text.
+        The :class:`Material` of the text.  Texts made without one share the default text material.
+        The text's color is passed to the vertex shader as the ``vertex_color`` attribute at location 1, the ``text_color`` uniform is left white.
         """
 
     @property
@@ -2781,6 +3342,7 @@ class Text:
 class CubeMap:
     """
     A cubemap.  Can be used to create a :class:`SkyBox` .
+    When all six faces have cooked ``.lxt`` files of the same format (see :meth:`Texture.cook`), those are loaded with their mip chains instead.
     """
     def __init__(self, right_path:str, left_path:str, top_path:str, bottom_path:str, back_path:str, front_path:str) -> None:
         ...
@@ -2822,8 +3384,10 @@ class Emitter:
     Emits particles.
     """
 
-    def __init__(self, position:Vec3, direction:Quaternion, scale_min:Vec2 = Vec2(1.0, 1.0), scale_max:Vec2 = Vec2(1.0, 1.0), rate:int = 50, decay_rate:float = 1.0, spread:float = math.radians(30), velocity_decay:float = 1.0, start_velocity_min:float = 1.0, start_velocity_max:float = 1.0, start_lifetime_min:float = 10.0, start_lifetime_max:float = 10.0, color_min:Vec4 = Vec4(1.0,1.0,1.0,1.0), color_max:Vec4 = Vec4(1.0,1.0,1.0,1.0), material:Material | None = None) -> None:
-        ...
+    def __init__(self, position:Vec3, direction:Quaternion, scale_min:Vec2 = Vec2(1.0, 1.0), scale_max:Vec2 = Vec2(1.0, 1.0), rate:int = 50, decay_rate:float = 1.0, spread:float = math.radians(30), velocity_decay:float = 1.0, start_velocity_min:float = 1.0, start_velocity_max:float = 1.0, start_lifetime_min:float = 10.0, start_lifetime_max:float = 10.0, color_min:Vec4 = Vec4(1.0,1.0,1.0,1.0), color_max:Vec4 = Vec4(1.0,1.0,1.0,1.0), material:Material | None = None, instanced:bool = False) -> None:
+        """
+        When no ``material`` is given, ``instanced`` picks the default one that draws the particles as instanced quads instead of expanding points in a geometry shader.  See :attr:`Emitter.instanced` .
+        """
         
 
     def start(self) -> None:
@@ -3038,6 +3602,98 @@ class Emitter:
         The maximum starting life value of a particle.    The start life value of a particle will be randomly selected between `Emitter.start_lifetime_min` and `Emitter.start_lifetime_max` .
         """
 
+    # instanced
+
+    @property
+    def instanced(self) -> bool:
+        """
+        Whether the particles are drawn as instanced quads, billboarded in the vertex shader, which is the case for any :attr:`Emitter.material` without a geometry shader.
+        Materials with one get a point per particle to expand themselves.  Geometry shaders are slow on many drivers, software ones especially, see ``benchmarks/particle_render.py`` .
+        """
+
+    # depth_sort
+
+    @property
+    def depth_sort(self) -> bool:
+        """
+        When set, the particles are drawn farthest first so alpha blended particles composite correctly.  Costs a sort per frame, see :meth:`ParticleProfiler.stats` .  Defaults to ``False``.
+        """
+
+    @depth_sort.setter
+    def depth_sort(self, value:bool) -> None:
+        """
+        When set, the particles are drawn farthest first so alpha blended particles composite correctly.  Costs a sort per frame, see :meth:`ParticleProfiler.stats` .  Defaults to ``False``.
+        """
+
+    # collision
+
+    @property
+    def collision_response(self) -> CollisionResponse:
+        """
+        What particles do when they end up inside one of the emitter's collision shapes (see :meth:`Emitter.add_collision_plane`) or, with :attr:`Emitter.collide_colliders` , a :class:`BoxCollider` :
+        ``BOUNCE`` pushes them out and reflects their velocity scaled by :attr:`Emitter.restitution` , ``STICK`` pushes them out and stops them, ``KILL`` respawns them.  Defaults to ``NONE``, no collision.
+        """
+
+    @collision_response.setter
+    def collision_response(self, value:CollisionResponse) -> None:
+        """
+        What particles do when they end up inside one of the emitter's collision shapes (see :meth:`Emitter.add_collision_plane`) or, with :attr:`Emitter.collide_colliders` , a :class:`BoxCollider` :
+        ``BOUNCE`` pushes them out and reflects their velocity scaled by :attr:`Emitter.restitution` , ``STICK`` pushes them out and stops them, ``KILL`` respawns them.  Defaults to ``NONE``, no collision.
+        """
+
+    @property
+    def restitution(self) -> float:
+        """
+        The share of a bouncing particle's velocity into the shape that it keeps, 0 to 1.  Defaults to 0.5.
+        """
+
+    @restitution.setter
+    def restitution(self, value:float) -> None:
+        """
+        The share of a bouncing particle's velocity into the shape that it keeps, 0 to 1.  Defaults to 0.5.
+        """
+
+    @property
+    def collide_colliders(self) -> bool:
+        """
+        When set, the particles also collide with the :class:`BoxCollider`\s of the objects added to the :class:`Window` , as oriented boxes.  Only the boxes near the particles are tested.  Defaults to ``False``.
+        """
+
+    @collide_colliders.setter
+    def collide_colliders(self, value:bool) -> None:
+        """
+        When set, the particles also collide with the :class:`BoxCollider`\s of the objects added to the :class:`Window` , as oriented boxes.  Only the boxes near the particles are tested.  Defaults to ``False``.
+        """
+
+    def add_collision_plane(self, point:Vec3, normal:Vec3) -> None:
+        """
+        Adds an infinite plane through ``point`` in world space.  Particles behind ``normal`` are inside it, so a ground plane is ``add_collision_plane(Vec3(0,0,0), Vec3(0,1,0))`` .
+        """
+
+    def add_collision_sphere(self, center:Vec3, radius:float) -> None:
+        """
+        Adds a sphere in world space.
+        """
+
+    def clear_collision_shapes(self) -> None:
+        """
+        Removes the planes and spheres added to the emitter.
+        """
+
+    # seed
+
+    @property
+    def seed(self) -> int:
+        """
+        The seed of the emitter's random numbers.  Emitters are seeded in the order they are created, so the same effect plays out the same way every run.
+        """
+
+    @seed.setter
+    def seed(self, value:int) -> None:
+        """
+        Reseeds the emitter and respawns all of its particles, restarting the effect.  Useful for replaying an effect exactly, for example when benchmarking.
+        """
+
 class Sound:
     """
     A sound asset.  This can also be used to play sounds directly.
@@ -28,12 +28,201 @@ cdef class Texture:
     @classmethod
     def from_file(cls, str file_path, TextureWraping wrap = TextureWraping.REPEAT, TextureFiltering filtering = TextureFiltering.LINEAR) -> Texture:
         return Texture_from_file(file_path, wrap, filtering)
-        
 
+    @staticmethod
+    def cook(str source_path, str out_path = None, CookedFormat format = CookedFormat.BC1, bint generate_mips = True) -> str:
+        if out_path is None:
+            out_path = cooked_texture.cooked_path(source_path.encode()).decode()
+        cdef string c_source = source_path.encode()
+        cdef string c_out = out_path.encode()
+        # no gl involved, let Loxoc.cook run several of these at once.
+        with nogil:
+            cooked_texture.cook(c_source, c_out, format, generate_mips)
+        return out_path
+
+    @staticmethod
+    def set_prefer_cooked(bint value) -> None:
+        cooked_texture.set_prefer_cooked(value)
+
+    @staticmethod
+    def is_prefer_cooked() -> bint:
+        return cooked_texture.is_prefer_cooked()
+
+    @property
+    def cooked(self) -> bint:
+        return not self.c_class.data.cooked_path.empty()
+
+    @property
+    def streamed(self) -> bint:
+        return self.c_class.data.is_streamed()
+
+    @property
+    def mip_levels(self) -> int:
+        return self.c_class.data.mip_levels()
+
+    @property
+    def resident_level(self) -> int:
+        return self.c_class.data.resident_level
+
+    @property
+    def wanted_level(self) -> int:
+        return self.c_class.data.wanted_level
+
+    @property
+    def resident_bytes(self) -> int:
+        return self.c_class.data.resident_bytes
 
     def __dealloc__(self):
         RC_collect(self.c_class)
 
+cdef class TextureStreaming:
+    @staticmethod
+    def set_enabled(bint value) -> None:
+        texture_streamer.set_enabled(value)
+
+    @staticmethod
+    def is_enabled() -> bint:
+        return texture_streamer.is_enabled()
+
+    @staticmethod
+    def set_budget(size_t bytes) -> None:
+        texture_streamer.set_budget(bytes)
+
+    @staticmethod
+    def get_budget() -> int:
+        return texture_streamer.get_budget()
+
+    @staticmethod
+    def stats() -> dict:
+        cdef texture_stream_stats st = texture_streamer.get_stats()
+        return {
+            "budget_bytes": st.budget_bytes,
+            "resident_bytes": st.resident_bytes,
+            "textures": st.textures,
+            "fully_resident": st.fully_resident,
+            "pending": st.pending,
+            "raises": st.raises,
+            "evictions": st.evictions,
+        }
+
+cdef class AnimationLOD:
+    @staticmethod
+    def set_enabled(bint value) -> None:
+        animation_lod.set_enabled(value)
+
+    @staticmethod
+    def is_enabled() -> bint:
+        return animation_lod.is_enabled()
+
+    @staticmethod
+    def set_rate_thresholds(float half, float quarter, float eighth) -> None:
+        animation_lod.set_rate_thresholds(half, quarter, eighth)
+
+    @staticmethod
+    def set_detail_threshold(float px) -> None:
+        animation_lod.set_detail_threshold(px)
+
+    @staticmethod
+    def set_pause_offscreen(bint value) -> None:
+        animation_lod.set_pause_offscreen(value)
+
+    @staticmethod
+    def stats() -> dict:
+        cdef animation_lod_stats st = animation_lod.get_stats()
+        return {
+            "objects": st.objects,
+            "offscreen": st.offscreen,
+            "reduced_rate": st.reduced_rate,
+            "detail_culled": st.detail_culled,
+            "channels_evaluated": st.channels_evaluated,
+            "channels_saved": st.channels_saved,
+        }
+
+cdef class ClipCompression:
+    @staticmethod
+    def set_tolerances(float position, float rotation, float scale) -> None:
+        clip_compression.set_tolerances(position, rotation, scale)
+
+    @staticmethod
+    def stats() -> dict:
+        cdef clip_compression_stats st = clip_compression.get_stats()
+        return {
+            "channels": st.channels,
+            "constant_channels": st.constant_channels,
+            "source_keys": st.source_keys,
+            "kept_keys": st.kept_keys,
+            "source_bytes": st.source_bytes,
+            "compressed_bytes": st.compressed_bytes,
+            "ratio": st.source_bytes / st.compressed_bytes if st.compressed_bytes else 0.0,
+            "max_position_error": st.max_position_error,
+            "max_rotation_error": st.max_rotation_error,
+            "max_scale_error": st.max_scale_error,
+        }
+
+    @staticmethod
+    def reset_stats() -> None:
+        clip_compression.reset_stats()
+
+cdef class StreamBuffer:
+    @staticmethod
+    def set_allow_persistent(bint value) -> None:
+        stream_buffer.set_allow_persistent(value)
+
+    @staticmethod
+    def stats() -> dict:
+        cdef stream_buffer_stats st = stream_buffer.get_global().get_stats()
+        return {
+            "frame_bytes": st.frame_bytes,
+            "peak_frame_bytes": st.peak_frame_bytes,
+            "frame_capacity": st.frame_capacity,
+            "stalls": st.stalls,
+            "grows": st.grows,
+            "persistent": st.persistent,
+        }
+
+cdef class ParticleProfiler:
+    @staticmethod
+    def stats() -> dict:
+        cdef particle_stats st = particle_profiler.get_stats()
+        return {
+            "emitters": st.emitters,
+            "particles": st.particles,
+            "culled_emitters": st.culled_emitters,
+            "skipped_emitters": st.skipped_emitters,
+            "reduced_emitters": st.reduced_emitters,
+            "simulated_particles": st.simulated_particles,
+            "drawn_particles": st.drawn_particles,
+            "sorted_emitters": st.sorted_emitters,
+            "sorted_particles": st.sorted_particles,
+            "reused_orders": st.reused_orders,
+            "radix_sorts": st.radix_sorts,
+            "sort_ms": st.sort_ms,
+            "collision_emitters": st.collision_emitters,
+            "collisions": st.collisions,
+            "collision_ms": st.collision_ms,
+        }
+
+cdef class ParticleLOD:
+    @staticmethod
+    def set_enabled(bint value) -> None:
+        particle_lod.set_enabled(value)
+
+    @staticmethod
+    def is_enabled() -> bool:
+        return particle_lod.is_enabled()
+
+    @staticmethod
+    def set_distance(float full_rate, float minimum) -> None:
+        particle_lod.set_distance(full_rate, minimum)
+
+    @staticmethod
+    def set_cull_offscreen(bint value) -> None:
+        particle_lod.set_cull_offscreen(value)
+
+    @staticmethod
+    def set_coarse_interval(int frames) -> None:
+        particle_lod.set_coarse_interval(frames)
+
 cdef Texture texture_from_cpp(RC[texture*]* cppinst):
     cdef:
         Texture ret = Texture.__new__(Texture)
@@ -289,7 +478,12 @@ cdef class Mesh:
         return model_from_file(file_path, animated)
 
 cpdef Model model_from_file(str file_path, bint animated):
-    return Model.from_cpp_ptr(mesh.from_file(file_path.encode(), animated))
+    cdef:
+        RC[model*]* cppinst = mesh.from_file(file_path.encode(), animated)
+        Model ret = Model.from_cpp_ptr(cppinst)
+    # from_cpp_ptr takes its own reference, drop the one from_file handed back.
+    RC_collect(cppinst)
+    return ret
 
 ctypedef model* model_ptr
 
@@ -303,6 +497,14 @@ cdef class Model:
     def from_file(str file_path, bint animated = False) -> Model:
         return model_from_file(file_path, animated)
 
+    @staticmethod
+    def from_file_async(str file_path, bint animated = False) -> ModelLoader:
+        return ModelLoader(file_path, animated)
+
+    @property
+    def loaded(self) -> bint:
+        return self.c_class.data.loaded
+
     @property
     def use_default_material_properties(self) -> bint:
         return self.c_class.data.use_default_material_properties
@@ -314,6 +516,13 @@ cdef class Model:
     cpdef void play_animation(self, str animation):
         self.c_class.data.play_animation(animation.encode())
 
+    cpdef void bake_animation(self, str animation, float fps = 30.0):
+        self.c_class.data.bake_animation(animation.encode(), fps)
+
+    @property
+    def baked(self) -> bint:
+        return self.c_class.data.baked
+
     @property
     def mesh_dict(self) -> MeshDict:
         return self._mesh_data
@@ -348,6 +557,42 @@ cdef class Model:
     def __dealloc__(self):
         RC_collect(self.c_class)
 
+cdef class ModelLoader:
+    def __init__(self, str file_path, bint animated = False) -> None:
+        self.c_class = new model_loader(file_path.encode(), animated)
+        self._model = Model.from_cpp_ptr(self.c_class.result)
+
+    @property
+    def model(self) -> Model:
+        return self._model
+
+    @property
+    def state(self) -> LoadState:
+        return self.c_class.get_state()
+
+    @property
+    def ready(self) -> bint:
+        return self.c_class.is_ready()
+
+    @property
+    def failed(self) -> bint:
+        return self.c_class.get_state() == LoadState.FAILED
+
+    @property
+    def error(self) -> str:
+        return bytes(self.c_class.get_error()).decode()
+
+    @property
+    def file_path(self) -> str:
+        return bytes(self.c_class.file_path).decode()
+
+    cpdef Model finish(self):
+        self.c_class.finish()
+        return self._model
+
+    def __dealloc__(self):
+        del self.c_class
+
 cdef class Object3D:
     def __init__(self, Model model_data, Vec3 position = None,
     Vec3 rotation = None, Vec3 scale = None,
@@ -364,7 +609,7 @@ cdef class Object3D:
             else:
                 self.c_class = new object3d(self._model_data.c_class, self._position.c_class, self._rotation.c_class, self._scale.c_class, self._material.c_class)
         else:
-            self._material = Material(animated=self._model_data.animated)
+            self._material = Material(animated=self._model_data.animated, baked=self._model_data.c_class.data.baked)
 
             if collider is not None:
                 self.c_class = new object3d(self._model_data.c_class, self._position.c_class, self._rotation.c_class, self._scale.c_class, self._material.c_class, collider.c_class)
@@ -405,7 +650,26 @@ cdef class Object3D:
         return False
 
     cpdef void play_animation(self, str animation_name):
-        self._model_data.play_animation(animation_name)
+        self.c_class.play_animation(animation_name.encode())
+
+    @property
+    def baked_time_offset(self) -> float:
+        return self.c_class.baked_time_offset
+
+    @baked_time_offset.setter
+    def baked_time_offset(self, float value) -> None:
+        self.c_class.baked_time_offset = value
+
+    def refit_colliders(self) -> None:
+        self.c_class.refit_colliders()
+
+    @property
+    def refit_colliders_on_update(self) -> bint:
+        return self.c_class.refit_colliders_on_update
+
+    @refit_colliders_on_update.setter
+    def refit_colliders_on_update(self, bint value) -> None:
+        self.c_class.refit_colliders_on_update = value
 
     @property
     def position(self) -> Vec3:
@@ -480,9 +744,10 @@ cdef class Shader:
 
     @classmethod
     def from_file(cls, str filepath, ShaderType type) -> Shader:
-        with open(filepath, 'r') as fp:
-            src = fp.read()
-        return cls(src, type)
+        cdef Shader ret = Shader.__new__(Shader)
+        # the cache already took a reference for us.
+        ret.c_class = resource_cache.get_shader(filepath.encode(), type)
+        return ret
 
     @staticmethod
     cdef Shader from_cpp(RC[shader*]* cppinst):
@@ -492,6 +757,94 @@ cdef class Shader:
         ret.c_class.inc()
         return ret
 
+cdef class ResourceCache:
+    @staticmethod
+    def stats() -> dict:
+        cdef resource_stats st = resource_cache.get_stats()
+        return {
+            "shader_file_reads": st.shader_file_reads,
+            "shader_hits": st.shader_hits,
+            "shader_misses": st.shader_misses,
+            "program_hits": st.program_hits,
+            "program_links": st.program_links,
+            "program_binary_loads": st.program_binary_loads,
+            "texture_hits": st.texture_hits,
+            "texture_decodes": st.texture_decodes,
+            "texture_bytes": st.texture_bytes,
+            "programs": st.programs,
+            "textures": st.textures,
+            "last_import_ms": st.last_import_ms,
+            "last_texture_decode_ms": st.last_texture_decode_ms,
+        }
+
+    @staticmethod
+    def reset_stats() -> None:
+        resource_cache.reset_stats()
+
+    @staticmethod
+    def set_enabled(bint value) -> None:
+        resource_cache.set_enabled(value)
+
+    @staticmethod
+    def is_enabled() -> bint:
+        return resource_cache.is_enabled()
+
+    @staticmethod
+    def set_parallel_decode(bint value) -> None:
+        resource_cache.set_parallel_decode(value)
+
+    @staticmethod
+    def is_parallel_decode() -> bint:
+        return resource_cache.is_parallel_decode()
+
+    @staticmethod
+    def purge_unused() -> int:
+        return resource_cache.purge_unused()
+
+    @staticmethod
+    def clear() -> None:
+        resource_cache.clear()
+
+    @staticmethod
+    def clear_textures() -> None:
+        resource_cache.clear_textures()
+
+cdef class ProgramCache:
+    @staticmethod
+    def stats() -> dict:
+        cdef program_cache_stats st = program_binary_cache.get_stats()
+        return {
+            "hits": st.hits,
+            "misses": st.misses,
+            "rejected": st.rejected,
+            "stored": st.stored,
+            "unsupported": st.unsupported,
+        }
+
+    @staticmethod
+    def reset_stats() -> None:
+        program_binary_cache.reset_stats()
+
+    @staticmethod
+    def set_directory(str path) -> None:
+        program_binary_cache.set_directory(path.encode())
+
+    @staticmethod
+    def get_directory() -> str:
+        return program_binary_cache.get_directory().decode()
+
+    @staticmethod
+    def set_enabled(bint value) -> None:
+        program_binary_cache.set_enabled(value)
+
+    @staticmethod
+    def is_enabled() -> bint:
+        return program_binary_cache.is_enabled()
+
+    @staticmethod
+    def clear() -> int:
+        return program_binary_cache.clear()
+
 cdef class Quaternion:
     def __init__(self, float w, float x, float y, float z) -> None:
         self.c_class = new quaternion(w,x,y,z)
@@ -1189,9 +1542,11 @@ cdef Vec2 vec2_from_cpp(vec2 cppinst):
 ctypedef material* material_ptr
 
 cdef class Material:
-    def __init__(self, Shader vertex = None, Shader fragment = None, Shader geometry = None, Shader compute = None, bint animated = False) -> None:
+    def __init__(self, Shader vertex = None, Shader fragment = None, Shader geometry = None, Shader compute = None, bint animated = False, bint baked = False) -> None:
         if vertex:
             self._vertex_shader = vertex
+        elif baked:
+            self._vertex_shader = Shader.from_file(path.join(path.dirname(__file__), "default_vertex_baked.glsl"), ShaderType.VERTEX)
         else:
             self._vertex_shader = Shader.from_file(path.join(path.dirname(__file__), "default_vertex_animated.glsl" if animated else "default_vertex.glsl"), ShaderType.VERTEX)
 
@@ -1228,12 +1583,12 @@ cdef class Material:
 
     @diffuse_texture.setter
     def diffuse_texture(self, Texture value):
+        # swap the handle rather than copying into it, the old texture may be shared through the ResourceCache.
+        value.c_class.inc()
         if self.c_class.data.diffuse_texture:
-            self.c_class.data.diffuse_texture.data[0] = value.c_class.data[0]
-        else:
-            self.c_class.data.diffuse_texture = value.c_class
-        if not self._diffuse_texture:
-            self._diffuse_texture = texture_from_cpp(self.c_class.data.diffuse_texture)
+            RC_collect(self.c_class.data.diffuse_texture)
+        self.c_class.data.diffuse_texture = value.c_class
+        self._diffuse_texture = value
 
     @property
     def specular_texture(self) -> Texture:
@@ -1241,12 +1596,12 @@ cdef class Material:
 
     @specular_texture.setter
     def specular_texture(self, Texture value):
+        # swap the handle rather than copying into it, the old texture may be shared through the ResourceCache.
+        value.c_class.inc()
         if self.c_class.data.specular_texture:
-            self.c_class.data.specular_texture.data[0] = value.c_class.data[0]
-        else:
-            self.c_class.data.specular_texture = value.c_class
-        if not self._specular_texture:
-            self._specular_texture = texture_from_cpp(self.c_class.data.specular_texture)
+            RC_collect(self.c_class.data.specular_texture)
+        self.c_class.data.specular_texture = value.c_class
+        self._specular_texture = value
 
     @property
     def normals_texture(self) -> Texture:
@@ -1254,12 +1609,12 @@ cdef class Material:
 
     @normals_texture.setter
     def normals_texture(self, Texture value):
+        # swap the handle rather than copying into it, the old texture may be shared through the ResourceCache.
+        value.c_class.inc()
         if self.c_class.data.normals_texture:
-            self.c_class.data.normals_texture.data[0] = value.c_class.data[0]
-        else:
-            self.c_class.data.normals_texture = value.c_class
-        if not self._normals_texture:
-            self._normals_texture = texture_from_cpp(self.c_class.data.normals_texture)
+            RC_collect(self.c_class.data.normals_texture)
+        self.c_class.data.normals_texture = value.c_class
+        self._normals_texture = value
     
     cpdef void set_uniform(self, str name, value:UniformValueType):
         _set_uniform(self, name, value)
@@ -1329,6 +1684,30 @@ cdef class Window:
     def deltatime(self) -> double:
         return self.c_class.deltatime
 
+    @property
+    def upload_budget(self) -> double:
+        return self.c_class.upload_budget
+
+    @upload_budget.setter
+    def upload_budget(self, double value):
+        self.c_class.upload_budget = value
+
+    @property
+    def parallel_animation(self) -> bint:
+        return self.c_class.parallel_animation
+
+    @parallel_animation.setter
+    def parallel_animation(self, bint value):
+        self.c_class.parallel_animation = value
+
+    @property
+    def parallel_particles(self) -> bint:
+        return self.c_class.parallel_particles
+
+    @parallel_particles.setter
+    def parallel_particles(self, bint value):
+        self.c_class.parallel_particles = value
+
     @property
     def dt(self) -> double:
         return self.c_class.deltatime
@@ -3014,13 +3393,31 @@ cdef class Font:
     def __dealloc__(self):
         del self.c_class
 
+# shared by every Text made without a material, so they are drawn together.
+cdef Material _default_text_material = None
+
+cdef class TextProfiler:
+    @staticmethod
+    def stats() -> dict:
+        cdef text_stats st = text_batcher.get_stats()
+        return {
+            "texts": st.texts,
+            "glyphs": st.glyphs,
+            "draws": st.draws,
+            "relayouts": st.relayouts,
+            "uploaded_bytes": st.uploaded_bytes,
+        }
+
 cdef class Text:
     def __init__(self, str text_string, Vec4 color, Vec2 position, Vec2 scale = None, float rotation = 0, Font font = None, Material material = None) -> None:
+        global _default_text_material
         self._position = position
         self._scale = scale if scale else Vec2(1.0, 1.0)
         self._font = font
         self._color = color
-        self._material = material if material else Material(Shader.from_file(path.join(path.dirname(__file__), "default_vertex_text.glsl"), ShaderType.VERTEX), Shader.from_file(path.join(path.dirname(__file__), "default_fragment_text.glsl"), ShaderType.FRAGMENT))
+        if not material and _default_text_material is None:
+            _default_text_material = Material(Shader.from_file(path.join(path.dirname(__file__), "default_vertex_text.glsl"), ShaderType.VERTEX), Shader.from_file(path.join(path.dirname(__file__), "default_fragment_text.glsl"), ShaderType.FRAGMENT))
+        self._material = material if material else _default_text_material
         self.c_class = new text(text_string.encode(), self._font.c_class, self._color.c_class, self._position.c_class, self._scale.c_class, rotation, self._material.c_class)
 
     @property
@@ -3061,7 +3458,9 @@ cdef class Text:
 
     @material.setter
     def material(self, Material value):
-        self._material.c_class.data[0] = value.c_class.data[0]
+        # the default material is shared, so the text takes value itself instead of copying it over.
+        self._material = value
+        self.c_class.mat = value.c_class
 
     @property
     def font(self) -> Font:
@@ -3117,18 +3516,26 @@ cdef class SkyBox:
 
 cdef class Emitter:
 
-    def __init__(self, Vec3 position, Quaternion direction, Vec2 scale_min = None, Vec2 scale_max = None, int rate = 50, float decay_rate = 1.0, float spread = math.radians(30), float velocity_decay = 1.0, float start_velocity_min = 1.0, float start_velocity_max = 1.0, float start_lifetime_min = 10.0, float start_lifetime_max = 10.0, Vec4 color_min = None, Vec4 color_max = None, Material material = None) -> None:
+    def __init__(self, Vec3 position, Quaternion direction, Vec2 scale_min = None, Vec2 scale_max = None, int rate = 50, float decay_rate = 1.0, float spread = math.radians(30), float velocity_decay = 1.0, float start_velocity_min = 1.0, float start_velocity_max = 1.0, float start_lifetime_min = 10.0, float start_lifetime_max = 10.0, Vec4 color_min = None, Vec4 color_max = None, Material material = None, bint instanced = False) -> None:
         self._position = position
         self._direction = direction
         self._color_min = color_min if color_min else Vec4(1.0,1.0,1.0,1.0)
         self._color_max = color_max if color_max else Vec4(1.0,1.0,1.0,1.0)
         self._scale_min = scale_min if scale_min else Vec2(1.0, 1.0)
         self._scale_max = scale_max if scale_max else Vec2(1.0, 1.0)
-        self._material = material if material else Material(
-            Shader.from_file(path.join(path.dirname(__file__), "default_vertex_particle.glsl"), ShaderType.VERTEX),
-            Shader.from_file(path.join(path.dirname(__file__), "default_fragment_particle.glsl"), ShaderType.FRAGMENT),
-            Shader.from_file(path.join(path.dirname(__file__), "default_geometry_particle.glsl"), ShaderType.GEOMETRY)
-        )
+        if material:
+            self._material = material
+        elif instanced:
+            self._material = Material(
+                Shader.from_file(path.join(path.dirname(__file__), "default_vertex_particle_instanced.glsl"), ShaderType.VERTEX),
+                Shader.from_file(path.join(path.dirname(__file__), "default_fragment_particle.glsl"), ShaderType.FRAGMENT)
+            )
+        else:
+            self._material = Material(
+                Shader.from_file(path.join(path.dirname(__file__), "default_vertex_particle.glsl"), ShaderType.VERTEX),
+                Shader.from_file(path.join(path.dirname(__file__), "default_fragment_particle.glsl"), ShaderType.FRAGMENT),
+                Shader.from_file(path.join(path.dirname(__file__), "default_geometry_particle.glsl"), ShaderType.GEOMETRY)
+            )
 
         self._material.diffuse_texture = Texture.from_file(path.join(path.dirname(__file__), "default_particle.png"))
 
@@ -3158,6 +3565,10 @@ cdef class Emitter:
     def material(self, Material value):
         self._material.c_class.data[0] = value.c_class.data[0]
 
+    @property
+    def instanced(self) -> bint:
+        return self.c_class.draws_instanced()
+
     # POSITION
 
     @property
@@ -3290,6 +3701,61 @@ cdef class Emitter:
     def start_lifetime_max(self, float value) -> None:
         self.c_class.start_lifetime_max = value
 
+    # depth_sort
+
+    @property
+    def depth_sort(self) -> bint:
+        return self.c_class.depth_sort
+
+    @depth_sort.setter
+    def depth_sort(self, bint value) -> None:
+        self.c_class.depth_sort = value
+
+    # COLLISION
+
+    @property
+    def collision_response(self) -> CollisionResponse:
+        return self.c_class.collision_response
+
+    @collision_response.setter
+    def collision_response(self, CollisionResponse value) -> None:
+        self.c_class.collision_response = value
+
+    @property
+    def restitution(self) -> float:
+        return self.c_class.restitution
+
+    @restitution.setter
+    def restitution(self, float value) -> None:
+        self.c_class.restitution = value
+
+    @property
+    def collide_colliders(self) -> bint:
+        return self.c_class.collide_colliders
+
+    @collide_colliders.setter
+    def collide_colliders(self, bint value) -> None:
+        self.c_class.collide_colliders = value
+
+    def add_collision_plane(self, Vec3 point, Vec3 normal) -> None:
+        self.c_class.add_collision_plane(point.c_class[0], normal.c_class[0])
+
+    def add_collision_sphere(self, Vec3 center, float radius) -> None:
+        self.c_class.add_collision_sphere(center.c_class[0], radius)
+
+    def clear_collision_shapes(self) -> None:
+        self.c_class.clear_collision_shapes()
+
+    # seed
+
+    @property
+    def seed(self) -> int:
+        return self.c_class.get_seed()
+
+    @seed.setter
+    def seed(self, uint64_t value) -> None:
+        self.c_class.set_seed(value)
+
     cpdef void start(self):
         self.c_class.start()
 
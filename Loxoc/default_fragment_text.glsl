@@ -1,6 +1,6 @@
-
 #version 330 core
 in vec2 TexCoords;
+in vec4 TextColor;
 out vec4 color;
 
 uniform sampler2D text;
@@ -9,5 +9,5 @@ uniform vec4 text_color;
 void main()
 {    
     vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-    color = text_color * sampled;
-}
\ No newline at end of file
+    color = text_color * TextColor * sampled;
+}
@@ -10,32 +10,51 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
-const int MAX_BONES = 100;
 const int MAX_BONE_INFLUENCE = 4;
-uniform mat4 final_bones_matrices[MAX_BONES];
+// the bone palette, 4 texels (columns) per bone matrix.
+uniform samplerBuffer bone_palette;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 
+mat4 bone_matrix(int id) {
+    int base = id * 4;
+    return mat4(
+        texelFetch(bone_palette, base),
+        texelFetch(bone_palette, base + 1),
+        texelFetch(bone_palette, base + 2),
+        texelFetch(bone_palette, base + 3)
+    );
+}
+
 void main() {
+    int total_bones = textureSize(bone_palette) / 4;
     vec4 totalPosition = vec4(0.0f);
     vec3 totalNormal = vec3(0.0f);
+    float totalWeight = 0.0f;
     
     for(int i = 0 ; i < MAX_BONE_INFLUENCE ; i++) {
         if(aBoneIds[i] == -1)
             continue;
-        if(aBoneIds[i] >= MAX_BONES) {
+        if(aBoneIds[i] >= total_bones) {
             totalPosition = vec4(aPos, 1.0f);
             totalNormal = aNormal;
             break;
         }
         
-        vec4 localPosition = final_bones_matrices[aBoneIds[i]] * vec4(aPos, 1.0f);
+        mat4 bone = bone_matrix(aBoneIds[i]);
+        vec4 localPosition = bone * vec4(aPos, 1.0f);
         totalPosition += localPosition * aWeights[i];
         
-        vec3 localNormal = mat3(final_bones_matrices[aBoneIds[i]]) * aNormal;
+        vec3 localNormal = mat3(bone) * aNormal;
         totalNormal += localNormal * aWeights[i];
+        totalWeight += aWeights[i];
+    }
+    // vertices without bone influences keep their bind pose.
+    if (totalWeight == 0.0f) {
+        totalPosition = vec4(aPos, 1.0f);
+        totalNormal = aNormal;
     }
 
     mat4 viewModel = view * model;
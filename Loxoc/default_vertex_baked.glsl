@@ -0,0 +1,45 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// a baked animation, see vertex_animation_texture.
+uniform sampler2D baked_positions;
+uniform sampler2D baked_normals;
+uniform int baked_width;
+uniform int baked_rows_per_frame;
+uniform int baked_frame_count;
+uniform float baked_fps;
+// seconds into the clip, per instance.
+uniform float baked_time;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+
+ivec2 baked_texel(int frame) {
+    return ivec2(gl_VertexID % baked_width, frame * baked_rows_per_frame + gl_VertexID / baked_width);
+}
+
+void main() {
+    vec3 position = aPos;
+    vec3 normal = aNormal;
+    if (baked_frame_count > 0) {
+        float frame = baked_time * baked_fps;
+        int frame_0 = min(int(frame), baked_frame_count - 1);
+        int frame_1 = min(frame_0 + 1, baked_frame_count - 1);
+        float blend = clamp(frame - float(frame_0), 0.0, 1.0);
+        position = mix(texelFetch(baked_positions, baked_texel(frame_0), 0).xyz, texelFetch(baked_positions, baked_texel(frame_1), 0).xyz, blend);
+        normal = mix(texelFetch(baked_normals, baked_texel(frame_0), 0).xyz, texelFetch(baked_normals, baked_texel(frame_1), 0).xyz, blend);
+    }
+
+    gl_Position = projection * view * model * vec4(position, 1.0);
+    FragPos = vec3(model * vec4(position, 1.0));
+    Normal = normal;
+    TexCoord = aTexCoord;
+}
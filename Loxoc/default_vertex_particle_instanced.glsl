@@ -0,0 +1,31 @@
+#version 330 core
+layout (location = 0) in vec3 aPosition;
+layout (location = 1) in vec4 aColor;
+layout (location = 2) in vec2 aScale;
+layout (location = 3) in float aLife;
+layout (location = 4) in float aStartingLife;
+// corner of the quad, the only attribute that changes per vertex, the rest are per particle.
+layout (location = 5) in vec2 aCorner;
+
+out vec2 tex_coords;
+out vec4 particle_color;
+out float life;
+out float starting_life;
+
+uniform mat4 projection;
+uniform mat4 view;
+
+void main() {
+    // Get the camera's right and up vectors from the view matrix
+    vec3 right = normalize(vec3(view[0][0], view[1][0], view[2][0]));
+    vec3 up = normalize(vec3(view[0][1], view[1][1], view[2][1]));
+
+    // same quad as default_geometry_particle.glsl, both sides are scaled by scale.x
+    vec3 corner = aPosition + (right * aCorner.x + up * aCorner.y) * aScale.x;
+
+    tex_coords = aCorner * 0.5 + 0.5;
+    particle_color = aColor;
+    life = aLife;
+    starting_life = aStartingLife;
+    gl_Position = projection * (view * vec4(corner, 1.0));
+}
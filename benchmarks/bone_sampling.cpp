@@ -0,0 +1,100 @@
+// Microbenchmark for bone keyframe sampling on long clips.
+// Compares the cursor + binary search lookup in bone::sample against a linear scan from key 0,
+// for forward playback and for random seeks, and prints how well the synthetic clip compressed.
+//
+//   g++ -O2 -std=c++20 -Isrc -Iglad/include -Istb benchmarks/bone_sampling.cpp src/Matrix.cpp src/Vec2.cpp src/Vec3.cpp \
+//       src/Vec4.cpp src/Quaternion.cpp src/util.cpp src/ClipCompression.cpp glad/src/gl.c -lassimp -o bone_sampling
+//   ./bone_sampling [keys] [bones]
+
+#include "Bone.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+static aiNodeAnim* make_channel(unsigned int keys) {
+    auto channel = new aiNodeAnim();
+    channel->mNumPositionKeys = channel->mNumRotationKeys = channel->mNumScalingKeys = keys;
+    channel->mPositionKeys = new aiVectorKey[keys];
+    channel->mRotationKeys = new aiQuatKey[keys];
+    channel->mScalingKeys = new aiVectorKey[keys];
+    for (unsigned int i = 0; i < keys; i++) {
+        double time = i;
+        channel->mPositionKeys[i] = aiVectorKey(time, aiVector3D(std::sin(i * 0.1f), std::cos(i * 0.1f), i * 0.01f));
+        channel->mRotationKeys[i] = aiQuatKey(time, aiQuaternion(aiVector3D(0, 1, 0), i * 0.05f));
+        channel->mScalingKeys[i] = aiVectorKey(time, aiVector3D(1.0f, 1.0f, 1.0f));
+    }
+    return channel;
+}
+
+// the lookup bone used before cursors: scan from the first key every sample.
+static int linear_key(const vector<float>& times, float animation_time) {
+    for (int i = 0; i < static_cast<int>(times.size()) - 1; ++i) {
+        if (animation_time < times[i + 1])
+            return i;
+    }
+    return static_cast<int>(times.size()) - 2;
+}
+
+template<typename F>
+static double time_ms(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    unsigned int keys = argc > 1 ? std::atoi(argv[1]) : 5000;
+    int bones = argc > 2 ? std::atoi(argv[2]) : 60;
+    const float duration = static_cast<float>(keys - 1);
+
+    aiNodeAnim* channel = make_channel(keys);
+    vector<bone> skeleton;
+    for (int b = 0; b < bones; b++)
+        skeleton.emplace_back("bone", b, channel);
+    delete channel;
+
+    vector<float> times(keys);
+    for (unsigned int i = 0; i < keys; i++)
+        times[i] = static_cast<float>(i);
+
+    // forward playback of the whole clip with 30 keys per second at 60fps, and as many random seeks.
+    const int frames = static_cast<int>(keys) * 2;
+    vector<float> forward(frames), seeks(frames);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> any_time(0.0f, duration);
+    for (int f = 0; f < frames; f++) {
+        forward[f] = std::fmod(f * 0.5f, duration);
+        seeks[f] = any_time(rng);
+    }
+
+    volatile float sink = 0.0f;
+    for (auto& [label, samples] : {std::pair{"forward", &forward}, std::pair{"seek", &seeks}}) {
+        double linear = time_ms([&] {
+            for (float t : *samples)
+                for (int b = 0; b < bones; b++)
+                    sink = sink + static_cast<float>(linear_key(times, t) * 3);
+        });
+        double cursor = time_ms([&] {
+            vector<bone_cursor> cursors(bones);
+            for (float t : *samples)
+                for (int b = 0; b < bones; b++)
+                    sink = sink + skeleton[b].sample(t, cursors[b])[3][0];
+        });
+        double lookup = time_ms([&] {
+            vector<bone_cursor> cursors(bones);
+            for (float t : *samples)
+                for (int b = 0; b < bones; b++)
+                    sink = sink + static_cast<float>(bone::find_key(times, t, cursors[b].position) * 3);
+        });
+        std::printf("%-8s %u keys x %d bones x %d frames: linear lookup %8.2f ms, cursor lookup %8.2f ms, full cursor sample %8.2f ms\n",
+            label, keys, bones, frames, linear, lookup, cursor);
+    }
+
+    clip_compression_stats st = clip_compression::get_stats();
+    std::printf("compression: %zu -> %zu keys, %zu -> %zu bytes (%.1fx), %zu of %zu channels constant\n",
+        st.source_keys, st.kept_keys, st.source_bytes, st.compressed_bytes,
+        st.compressed_bytes ? static_cast<double>(st.source_bytes) / st.compressed_bytes : 0.0, st.constant_channels, st.channels);
+    std::printf("max error: position %g, rotation %g rad, scale %g\n", st.max_position_error, st.max_rotation_error, st.max_scale_error);
+    return 0;
+}
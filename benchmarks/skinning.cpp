@@ -0,0 +1,68 @@
+// Microbenchmark for cpu skinning.
+// Skins a synthetic mesh with the scalar reference, the sse kernel and the thread pool, and checks they agree.
+//
+//   g++ -O2 -std=c++20 -pthread -Isrc -Iglad/include -Istb benchmarks/skinning.cpp src/Skinning.cpp src/ThreadPool.cpp \
+//       src/Matrix.cpp src/Vec2.cpp src/Vec3.cpp src/Vec4.cpp src/Quaternion.cpp src/util.cpp glad/src/gl.c -lassimp -o skinning
+//   ./skinning [vertices] [bones]
+
+#include "Skinning.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <algorithm>
+
+template<typename F>
+static double time_ms(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int bones = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int runs = 20;
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> bone_id(0, bones - 1);
+
+    vector<vertex> vertices(count);
+    for (auto& v : vertices) {
+        v.position = glm::vec3(unit(rng), unit(rng), unit(rng));
+        v.normal = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(0.0f, 0.0f, 2.0f));
+        glm::vec4 w = glm::abs(glm::vec4(unit(rng), unit(rng), unit(rng), unit(rng)));
+        v.weights = w / (w.x + w.y + w.z + w.w);
+        v.bone_ids = glm::ivec4(bone_id(rng), bone_id(rng), bone_id(rng), bone_id(rng));
+    }
+    vector<glm::mat4> palette(bones);
+    for (auto& m : palette)
+        m = glm::translate(glm::rotate(glm::mat4(1.0f), unit(rng) * 3.0f, glm::normalize(glm::vec3(unit(rng), unit(rng), 1.0f))), glm::vec3(unit(rng), unit(rng), unit(rng)));
+
+    vector<glm::vec3> ref_pos(count), ref_norm(count), pos(count), norm(count);
+    thread_pool* pool = thread_pool::get_global();
+
+    double scalar = time_ms([&] {
+        for (int r = 0; r < runs; r++)
+            skin_vertices_scalar(vertices.data(), count, palette.data(), palette.size(), ref_pos.data(), ref_norm.data());
+    });
+    double simd = time_ms([&] {
+        for (int r = 0; r < runs; r++)
+            skin_vertices(vertices.data(), count, palette.data(), palette.size(), pos.data(), norm.data());
+    });
+    float max_error = 0.0f;
+    for (size_t i = 0; i < count; i++)
+        max_error = std::max({max_error, glm::length(pos[i] - ref_pos[i]), glm::length(norm[i] - ref_norm[i])});
+    double parallel = time_ms([&] {
+        for (int r = 0; r < runs; r++)
+            skin_vertices_parallel(vertices.data(), count, palette.data(), palette.size(), pos.data(), norm.data(), pool);
+    });
+    for (size_t i = 0; i < count; i++)
+        max_error = std::max({max_error, glm::length(pos[i] - ref_pos[i]), glm::length(norm[i] - ref_norm[i])});
+
+    std::printf("%zu vertices x %d runs: scalar %8.2f ms, simd %8.2f ms, simd on %zu threads %8.2f ms, max difference %g\n",
+        count, runs, scalar, simd, pool->size() + 1, parallel, max_error);
+    return 0;
+}
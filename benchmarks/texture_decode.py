@@ -0,0 +1,50 @@
+"""
+Compares model import wall time with serial and parallel texture decoding.
+
+    python benchmarks/texture_decode.py path/to/model.gltf [runs]
+
+Use an asset that references many large textures, the gain scales with the number of unique images.
+"""
+import sys
+import time
+import math
+from Loxoc import Vec3, Camera, Window, Model, ResourceCache
+
+if len(sys.argv) < 2:
+    print(__doc__)
+    sys.exit(1)
+
+model_path = sys.argv[1]
+runs = int(sys.argv[2]) if len(sys.argv) > 2 else 5
+
+dim = (640, 360)
+camera = Camera(Vec3(0.0,0.0,0.0), Vec3(0.0,0.0,0.0), *dim, 10000, math.radians(60))
+window = Window("Texture decode benchmark", camera, *dim, False, Vec3(0.1,0.1,0.1))
+# textures are only decoded in parallel while the cache is enabled.
+ResourceCache.set_enabled(True)
+
+def bench(parallel: bool) -> tuple[float, float]:
+    ResourceCache.set_parallel_decode(parallel)
+    total = 0.0
+    decode = 0.0
+    for run in range(runs):
+        # forget the cached textures so each run decodes every image again.  purge_unused can't be used here,
+        # models keep their textures referenced after they are deleted.
+        ResourceCache.clear_textures()
+        decodes = ResourceCache.stats()["texture_decodes"]
+        start = time.perf_counter()
+        model = Model.from_file(model_path)
+        total += time.perf_counter() - start
+        stats = ResourceCache.stats()
+        assert stats["texture_decodes"] > decodes, f"run {run} decoded no textures, it only timed cache hits"
+        decode += stats["last_texture_decode_ms"]
+        del model
+    return total * 1000.0 / runs, decode / runs
+
+serial_total, serial_decode = bench(False)
+parallel_total, parallel_decode = bench(True)
+
+print(f"{model_path}, {runs} runs")
+print(f"serial:   import {serial_total:8.2f} ms   decode {serial_decode:8.2f} ms")
+print(f"parallel: import {parallel_total:8.2f} ms   decode {parallel_decode:8.2f} ms")
+print(f"speedup:  import {serial_total / parallel_total:8.2f}x   decode {serial_decode / max(parallel_decode, 1e-6):8.2f}x")
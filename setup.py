@@ -75,7 +75,8 @@ for compiler, args in [
         '-O3',
         '-std=c++20',
         '-static',
-        '-fpermissive'
+        '-fpermissive',
+        '-pthread'
     ])
 ]:
     BUILD_ARGS[compiler] = args
@@ -13,8 +13,11 @@
 #include "Model.h"
 #include "Bone.h"
 #include <map>
+#include <limits>
 #include "RC.h"
 #include "Material.h"
+#include "StreamBuffer.h"
+#include <cstring>
 
 using std::vector;
 using std::string;
@@ -28,6 +31,20 @@ struct assimp_node_data {
     vector<assimp_node_data> children;
 };
 
+// One node of the flattened hierarchy.  Nodes are stored parents first so a single forward pass
+// can compose every global transform.
+struct skeleton_node {
+    int parent = -1;
+    // index into animation::bones of the channel animating this node, -1 when it keeps its bind transform.
+    int channel = -1;
+    // index into the animator's final_bone_matricies, -1 for nodes that are not bones.
+    int bone_id = -1;
+    matrix4x4 transformation = matrix4x4(1.0f);
+    matrix4x4 offset = matrix4x4(1.0f);
+    // small end of the hierarchy (fingers, face etc.) that can keep its bind transform when the model is far away.
+    bool detail = false;
+};
+
 // ANIMATION CLASS (animator class is below this)
 
 class animation {
@@ -36,6 +53,12 @@ public:
     float ticks_per_second = 0.0f;
     vector<bone> bones;
     vector<bone_info> bone_info_list;
+    // the node tree flattened with its channels and bone offsets resolved, see flatten_heirarchy().
+    vector<skeleton_node> skeleton;
+    // channels on detail nodes, skipped by animators culling detail.
+    size_t detail_channels = 0;
+    // a subtree is detail when it spans less than this fraction of the skeleton's size, measured from its parent.
+    static constexpr float DETAIL_EXTENT = 0.1f;
 private:
     assimp_node_data assimp_animation_tree;
 public:
@@ -56,11 +79,13 @@ public:
         read_heirarchy_data(&assimp_animation_tree, scene->mRootNode);
         // assimp_animation_tree.transformation = matrix4x4(1.0f);
         read_missing_bones(animation, model);
+        flatten_heirarchy();
         dbg_vis_init();
     }
 
-    animation(const aiScene* scene, const aiAnimation * animation, RC<model*>* model) {
+    animation(const aiScene* scene, const aiAnimation * animation, RC<model*>* model, bool defer_upload = false) {
         // load the animation in from an aiScene and aiAnimation
+        // when defer_upload is set, dbg_vis_init must be called on the gl thread afterwards.
 
         duration = (float)animation->mDuration;
         ticks_per_second = (float)animation->mTicksPerSecond;
@@ -68,7 +93,9 @@ public:
         read_heirarchy_data(&assimp_animation_tree, scene->mRootNode);
         // assimp_animation_tree.transformation = matrix4x4(1.0f);
         read_missing_bones(animation, model);
-        dbg_vis_init();
+        flatten_heirarchy();
+        if (!defer_upload)
+            dbg_vis_init();
     }
     
     ~animation(){}
@@ -128,6 +155,84 @@ private:
         this->bone_info_list = bone_info_list;
     }
 
+    inline void flatten_heirarchy() {
+        // walks the node tree depth first so every parent lands before its children,
+        // resolving names to channel and bone indices once here instead of every frame.
+        skeleton.clear();
+        vector<std::pair<const assimp_node_data*, int>> stack = {{&assimp_animation_tree, -1}};
+        while (!stack.empty()) {
+            auto [node, parent] = stack.back();
+            stack.pop_back();
+
+            skeleton_node flat;
+            flat.parent = parent;
+            flat.transformation = node->transformation;
+            for (size_t i = 0; i < bones.size(); i++) {
+                if (bones[i].name == node->name) {
+                    flat.channel = static_cast<int>(i);
+                    break;
+                }
+            }
+            for (const auto& info : bone_info_list) {
+                if (info.name == node->name) {
+                    flat.bone_id = info.id;
+                    flat.offset = info.offset;
+                    break;
+                }
+            }
+            int index = static_cast<int>(skeleton.size());
+            skeleton.push_back(flat);
+            for (auto child = node->children.rbegin(); child != node->children.rend(); child++)
+                stack.push_back({&*child, index});
+        }
+        mark_detail_nodes();
+    }
+
+    inline void mark_detail_nodes() {
+        // finds the subtrees that are small next to the whole skeleton in the bind pose.  Fingers and face bones
+        // span a few centimeters from the hand or head they hang off, limbs and the spine span much more.
+        size_t count = skeleton.size();
+        vector<glm::vec3> positions(count);
+        vector<glm::mat4> globals(count);
+        glm::vec3 low(std::numeric_limits<float>::max()), high(-std::numeric_limits<float>::max());
+        for (size_t i = 0; i < count; i++) {
+            const skeleton_node& node = skeleton[i];
+            globals[i] = node.parent >= 0 ? globals[node.parent] * node.transformation.mat : node.transformation.mat;
+            positions[i] = glm::vec3(globals[i][3]);
+            low = glm::min(low, positions[i]);
+            high = glm::max(high, positions[i]);
+        }
+        float limit = glm::length(high - low) * DETAIL_EXTENT;
+
+        // nodes are parents first, so a subtree is the run of nodes after it that descend from it.
+        vector<size_t> subtree_end(count, count);
+        vector<size_t> open;
+        for (size_t i = 0; i < count; i++) {
+            while (!open.empty() && static_cast<int>(open.back()) != skeleton[i].parent) {
+                subtree_end[open.back()] = i;
+                open.pop_back();
+            }
+            open.push_back(i);
+        }
+
+        detail_channels = 0;
+        for (size_t i = 0; i < count; i++) {
+            skeleton_node& node = skeleton[i];
+            if (node.parent < 0)
+                continue;
+            if (skeleton[node.parent].detail) {
+                node.detail = true;
+            } else {
+                float extent = 0.0f;
+                for (size_t j = i; j < subtree_end[i]; j++)
+                    extent = std::max(extent, glm::length(positions[j] - positions[node.parent]));
+                node.detail = extent < limit;
+            }
+            if (node.detail && node.channel >= 0)
+                detail_channels++;
+        }
+    }
+
     inline void read_heirarchy_data(assimp_node_data * parent, const aiNode* src) {
         if (!src)
             throw std::runtime_error("Failed to load Assimp animation tree data.");
@@ -255,17 +360,11 @@ public:
         glDeleteShader(geometryShader);
         glDeleteShader(fragmentShader);
         
-        // Generate and bind VAO
+        // Generate and bind VAO, the lines are written to the streaming buffer when drawn.
         glGenVertexArrays(1, &VAO);
         glBindVertexArray(VAO);
-
-        // Generate and bind VBO for vertices
-        glGenBuffers(1, &VBO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, (bones.size()-1)*2 * sizeof(glm::vec3), nullptr, GL_DYNAMIC_DRAW);
-        // Set vertex attribute pointers
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(0);
+        glBindVertexArray(0);
     }
 
     inline void dbg_push_bone(matrix4x4 mat) {
@@ -277,12 +376,20 @@ public:
         auto t_loc = glGetUniformLocation(debug_shader, "transform");
         glUniformMatrix4fv(t_loc, 1, GL_FALSE, glm::value_ptr(cam->projection.mat * cam->view.mat * model_mat.mat));
 
-        // update the bones buffer
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, debug_bones.size() * sizeof(glm::vec3), debug_bones.data());
+        // write the bones to the streaming buffer
+        stream_buffer* stream = stream_buffer::get_global();
+        stream_range range = stream->allocate(debug_bones.size() * sizeof(glm::vec3), sizeof(glm::vec3));
+        if (!debug_bones.empty())
+            std::memcpy(range.data, debug_bones.data(), range.size);
+        stream->commit(range);
         
         glBindVertexArray(VAO);
-        glDrawArrays(GL_LINES, 0, debug_bones.size());
+        if (range.generation != stream_generation) {
+            stream_generation = range.generation;
+            glBindBuffer(GL_ARRAY_BUFFER, range.buffer);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        }
+        glDrawArrays(GL_LINES, static_cast<GLint>(range.offset / sizeof(glm::vec3)), debug_bones.size());
         glBindVertexArray(0);
         debug_bones.clear();
     }
@@ -290,21 +397,37 @@ public:
 private:
     //// debug
     vector<glm::vec3> debug_bones; // this is set in the animator.
-    unsigned int VAO = 0, VBO = 0, debug_shader = 0;
+    unsigned int VAO = 0, debug_shader = 0;
+    size_t stream_generation = 0;
     //
 };
 
 // ANIMATOR CLASS
 
+// Playback state of one object3d.  The animation it plays (bones, keys and skeleton) is owned by the model and
+// shared between every instance, the animator only holds the clock, key cursors and the resulting pose.
 class animator {
 public:
     // attributes
-    vector<matrix4x4> final_bone_matricies;
+    // one matrix per bone of the model, uploaded to the shader in a single texture buffer. (see upload_palette)
+    vector<glm::mat4> final_bone_matricies;
     animation* current_animation = nullptr;
     float current_time = 0.0f;
     float delta_time = 0.0f;
     bool show_debug = false;
 
+    // level of detail, set every frame before update() (see animation_lod).
+    // the pose is evaluated every update_rate frames and blended in between.
+    int update_rate = 1;
+    // detail nodes keep their bind transform.
+    bool cull_detail = false;
+    // only the clock advances, the pose is left as is.
+    bool clock_only = false;
+    // neither the clock nor the pose advance.
+    bool paused = false;
+    // keyframe channels sampled and skipped by the last update.
+    size_t channels_evaluated = 0, channels_saved = 0;
+
     inline void render_debug(const camera * cam, const matrix4x4 & model_mat) {
         if (show_debug && current_animation)
             current_animation->dbg_render(cam, model_mat);
@@ -314,11 +437,14 @@ public:
 
     animator(animation* animation = nullptr) {
         current_time = 0.0f;
-        current_animation = animation;
-        final_bone_matricies.reserve(100);
+        play(animation);
+    }
 
-        for (int i = 0; i < 100; i++)
-            final_bone_matricies.push_back(matrix4x4(1.0f));
+    ~animator() {
+        if (palette_texture)
+            glDeleteTextures(1, &palette_texture);
+        if (palette_buffer)
+            glDeleteBuffers(1, &palette_buffer);
     }
 
     // METHODS
@@ -326,51 +452,175 @@ public:
     inline void update(float dt) {
         // updates the current time of the animation and calls to calculate bone transforms
         delta_time = dt;
-        if (current_animation) {
-            current_time = fmod(current_time + current_animation->ticks_per_second * dt, current_animation->duration);
-            // ensure that the current time is not exceeding the animation durration. mod so it loops back over.
-            calculate_bone_transform(current_animation->get_assimp_animation_tree(), matrix4x4(1.0f));
+        channels_evaluated = channels_saved = 0;
+        if (!current_animation)
+            return;
+        if (paused) {
+            channels_saved = current_animation->bones.size();
+            return;
+        }
+        float step = current_animation->ticks_per_second * dt;
+        // ensure that the current time is not exceeding the animation durration. mod so it loops back over.
+        current_time = fmod(current_time + step, current_animation->duration);
+
+        size_t channels = current_animation->bones.size();
+        if (clock_only) {
+            channels_saved = channels;
+            pose_stale = true;
+            return;
+        }
+        if (update_rate <= 1 || pose_stale) {
+            calculate_bone_transforms();
+            pose_stale = false;
+            blend_rate = 0;
+            return;
         }
+
+        if (blend_rate != update_rate || frames_since_pose >= update_rate) {
+            // blend from what is on screen now to the pose where we will be update_rate frames from now.
+            from_pose = final_bone_matricies;
+            to_pose.resize(final_bone_matricies.size());
+            float ahead = fmod(current_time + step * (update_rate - 1), current_animation->duration);
+            channels_evaluated = evaluate_pose(ahead, to_pose);
+            channels_saved = channels - channels_evaluated;
+            frames_since_pose = 0;
+            blend_rate = update_rate;
+        } else {
+            channels_saved = channels;
+        }
+        frames_since_pose++;
+        float alpha = static_cast<float>(frames_since_pose) / update_rate;
+        for (size_t i = 0; i < final_bone_matricies.size(); i++)
+            final_bone_matricies[i] = from_pose[i] + (to_pose[i] - from_pose[i]) * alpha;
+        palette_dirty = true;
     }
 
+    // binds the bone palette for the material's shader, uploading it first when the pose changed since the last call.
+    // Called for every sub mesh but the upload only happens once per frame.  Before there is a pose an empty palette
+    // is bound instead, so the sampler never points at the material's maps.  Leaves texture unit 0 active.
     inline void set_uniforms(rc_material mater) {
-        for (int i = 0; i < final_bone_matricies.size(); i++) {
-            mater->data->set_uniform("final_bones_matrices[" + std::to_string(i) + "]", final_bone_matricies[i]);
+        if (palette_dirty)
+            upload_palette();
+        glActiveTexture(GL_TEX_N_ITTER[BONE_PALETTE_UNIT]);
+        glBindTexture(GL_TEXTURE_BUFFER, palette_texture ? palette_texture : empty_palette());
+        glActiveTexture(GL_TEX_N_ITTER[0]);
+        if (palette_program != mater->data->shader_program) {
+            palette_program = mater->data->shader_program;
+            palette_location = glGetUniformLocation(palette_program, "bone_palette");
         }
+        glUniform1i(palette_location, BONE_PALETTE_UNIT);
     }
 
     inline void play(animation* animation) {
         // plays the provided animation from the beginning
         current_animation = animation;
         current_time = 0.0f;
+        if (animation) {
+            global_transforms.resize(animation->skeleton.size(), matrix4x4(1.0f));
+            cursors.assign(animation->bones.size(), bone_cursor());
+            pose_stale = true;
+            // only the bones the model has, not a fixed maximum.
+            final_bone_matricies.assign(animation->bone_info_list.size(), glm::mat4(1.0f));
+            palette_dirty = true;
+        }
     }
 
-    inline void calculate_bone_transform(const assimp_node_data* node, matrix4x4 parent_transform) {
-        string node_name = node->name;
-        matrix4x4 bone_transform = node->transformation;
+    inline void calculate_bone_transforms() {
+        channels_evaluated = evaluate_pose(current_time, final_bone_matricies);
+        channels_saved = current_animation->bones.size() - channels_evaluated;
+        palette_dirty = true;
+    }
 
-        bone* bone = current_animation->find_bone(node_name);
+    // writes the pose at animation_time into palette, returns how many channels were sampled.
+    inline size_t evaluate_pose(float animation_time, vector<glm::mat4>& palette) {
+        // one pass over the flattened skeleton, parents are always evaluated before their children.
+        const auto& skeleton = current_animation->skeleton;
+        if (global_transforms.size() < skeleton.size())
+            global_transforms.resize(skeleton.size(), matrix4x4(1.0f));
+        if (cursors.size() < current_animation->bones.size())
+            cursors.resize(current_animation->bones.size());
+        int bone_count = static_cast<int>(palette.size());
+
+        size_t sampled = 0;
+        glm::mat4 pose;
+        for (size_t i = 0; i < skeleton.size(); i++) {
+            const skeleton_node& node = skeleton[i];
+            const glm::mat4* local = &node.transformation.mat;
+            if (node.channel >= 0 && !(cull_detail && node.detail)) {
+                pose = current_animation->bones[node.channel].sample(animation_time, cursors[node.channel]);
+                local = &pose;
+                sampled++;
+            }
 
-        if (bone) {
-            bone->update(current_time);
-            bone_transform = bone->local_transform;
+            // transform local bone space to the parent bone space to follow bone space heirarchy
+            glm::mat4& global_transformation = global_transforms[i].mat;
+            global_transformation = node.parent >= 0 ? global_transforms[node.parent].mat * *local : *local;
+
+            if (node.bone_id >= 0 && node.bone_id < bone_count)
+                palette[node.bone_id] = global_transformation * node.offset.mat;
         }
+        return sampled;
+    }
 
-        // transform local bone space to the parent bone space to follow bone space heirarchy
-        matrix4x4 global_transformation = parent_transform * bone_transform;
-        // 
-        auto bone_info_list = current_animation->bone_info_list;
-        for (unsigned int i = 0; i < bone_info_list.size(); i++) {
-			if (bone_info_list[i].name == node_name) {
-                int index = bone_info_list[i].id;
-				matrix4x4 offset = bone_info_list[i].offset;
-				final_bone_matricies[index] = global_transformation * offset;
-				break;
-			}
-		}
+    // the texture unit the palette is bound to, units below it are used by the material's maps.
+    static constexpr int BONE_PALETTE_UNIT = 3;
+private:
+    // a palette holding less than one matrix, the shader counts 0 bones and draws every vertex in its bind pose.
+    // Shared by every animator and never freed, like the stream buffer it lives as long as the context.
+    static inline GLuint empty_palette() {
+        static GLuint texture = 0;
+        if (!texture) {
+            const float texel[4] = {};
+            GLuint buffer;
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+            glBufferData(GL_TEXTURE_BUFFER, sizeof(texel), texel, GL_STATIC_DRAW);
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_BUFFER, texture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+        }
+        return texture;
+    }
 
-        for (int i = 0; i < node->children_size; i++) {
-            calculate_bone_transform(&node->children[i], global_transformation);
+    inline void upload_palette() {
+        palette_dirty = false;
+        if (final_bone_matricies.empty())
+            return;
+        GLsizeiptr size = final_bone_matricies.size() * sizeof(glm::mat4);
+        if (!palette_buffer) {
+            glGenBuffers(1, &palette_buffer);
+            glGenTextures(1, &palette_texture);
         }
+        glBindBuffer(GL_TEXTURE_BUFFER, palette_buffer);
+        if (size != palette_size) {
+            glBufferData(GL_TEXTURE_BUFFER, size, final_bone_matricies.data(), GL_STREAM_DRAW);
+            palette_size = size;
+            glBindTexture(GL_TEXTURE_BUFFER, palette_texture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, palette_buffer);
+        } else {
+            // orphan the old storage so we don't wait on draws still reading last frame's pose.
+            glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, size, final_bone_matricies.data());
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
     }
+
+    // global transform of every skeleton node for the current pose.
+    vector<matrix4x4> global_transforms;
+    // key cursor of every channel in current_animation->bones.
+    vector<bone_cursor> cursors;
+    // the two poses blended between at reduced update rates.
+    vector<glm::mat4> from_pose, to_pose;
+    int frames_since_pose = 0;
+    // the update rate the current blend was set up for, 0 when not blending.
+    int blend_rate = 0;
+    // the pose does not match the clock (just started, or was clock only).
+    bool pose_stale = true;
+    // texture buffer holding final_bone_matricies as 4 rgba32f texels per bone.
+    GLuint palette_buffer = 0, palette_texture = 0;
+    GLsizeiptr palette_size = 0;
+    bool palette_dirty = true;
+    GLuint palette_program = 0;
+    GLint palette_location = -1;
 };
@@ -0,0 +1,54 @@
+#include "AnimationLod.h"
+#include "Object3d.h"
+#include "Camera.h"
+#include "Model.h"
+#include "Animation.h"
+
+bool animation_lod::enabled = true;
+float animation_lod::half_rate_px = 200.0f;
+float animation_lod::quarter_rate_px = 100.0f;
+float animation_lod::eighth_rate_px = 50.0f;
+float animation_lod::detail_px = 150.0f;
+bool animation_lod::pause_offscreen = false;
+animation_lod_stats animation_lod::stats;
+
+void animation_lod::apply(object3d* obj, const camera& cam) {
+    animator* anim = obj->animation_player;
+    if (!anim)
+        return;
+    model* data = obj->model_data->data;
+    if (!enabled || !data->bounds_ready) {
+        anim->update_rate = 1;
+        anim->cull_detail = anim->clock_only = anim->paused = false;
+        return;
+    }
+
+    obj->get_model_matrix();
+    bool visible = cam.in_view(obj->model_matrix, data->aabb_min, data->aabb_max);
+    anim->paused = !visible && pause_offscreen;
+    anim->clock_only = !visible && !pause_offscreen;
+    if (!visible)
+        return;
+
+    float px = cam.screen_size(obj->model_matrix, data->aabb_min, data->aabb_max);
+    anim->update_rate = px < eighth_rate_px ? 8 : px < quarter_rate_px ? 4 : px < half_rate_px ? 2 : 1;
+    anim->cull_detail = px < detail_px;
+}
+
+void animation_lod::record_frame(const vector<object3d*>& objects) {
+    stats = animation_lod_stats();
+    for (object3d* obj : objects) {
+        const animator* anim = obj->animation_player;
+        if (!anim || !anim->current_animation)
+            continue;
+        stats.objects++;
+        if (anim->clock_only || anim->paused)
+            stats.offscreen++;
+        else if (anim->update_rate > 1)
+            stats.reduced_rate++;
+        if (anim->cull_detail && !anim->clock_only && !anim->paused)
+            stats.detail_culled++;
+        stats.channels_evaluated += anim->channels_evaluated;
+        stats.channels_saved += anim->channels_saved;
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+using std::vector;
+
+class object3d;
+class camera;
+
+struct animation_lod_stats {
+    // animated objects in the last frame.
+    size_t objects = 0;
+    // objects outside the view, clock only or paused.
+    size_t offscreen = 0;
+    // objects updating their pose less than every frame.
+    size_t reduced_rate = 0;
+    // objects holding their detail bones in the bind pose.
+    size_t detail_culled = 0;
+    // keyframe channels sampled and skipped in the last frame.
+    size_t channels_evaluated = 0;
+    size_t channels_saved = 0;
+};
+
+// Animation level of detail.  Before poses are evaluated the window measures how many pixels each animated object
+// covers on screen.  Small objects update their pose every 2nd, 4th or 8th frame and blend in between, and below
+// detail_px the small ends of the skeleton (fingers, face, see animation::mark_detail_nodes) keep their bind pose.
+// Objects outside the view only advance their clock, or are paused entirely with pause_offscreen.
+
+class animation_lod {
+public:
+    static bool enabled;
+    static inline void set_enabled(bool value) { enabled = value; }
+    static inline bool is_enabled() { return enabled; }
+
+    // objects smaller than these on screen (pixels across) update at 1/2, 1/4 and 1/8 rate.
+    static float half_rate_px, quarter_rate_px, eighth_rate_px;
+    static inline void set_rate_thresholds(float half, float quarter, float eighth) {
+        half_rate_px = half;
+        quarter_rate_px = quarter;
+        eighth_rate_px = eighth;
+    }
+    // objects smaller than this on screen skip their detail bones.
+    static float detail_px;
+    static inline void set_detail_threshold(float px) { detail_px = px; }
+    static bool pause_offscreen;
+    static inline void set_pause_offscreen(bool value) { pause_offscreen = value; }
+
+    // sets the lod of obj's animator for this frame.  Safe to call from worker threads.
+    static void apply(object3d* obj, const camera& cam);
+    // sums the counters of the animators updated this frame.
+    static void record_frame(const vector<object3d*>& objects);
+
+    static inline animation_lod_stats get_stats() { return stats; }
+private:
+    static animation_lod_stats stats;
+};
@@ -0,0 +1,116 @@
+#include "AsyncLoader.h"
+#include "ThreadPool.h"
+#include "Mesh.h"
+#include "Model.h"
+#include <chrono>
+#include <iostream>
+
+static std::mutex upload_lock;
+static std::deque<std::function<void()>> upload_jobs;
+
+void gl_upload_queue::push(std::function<void()> job) {
+    std::lock_guard<std::mutex> guard(upload_lock);
+    upload_jobs.push_back(std::move(job));
+}
+
+void gl_upload_queue::push_all(vector<std::function<void()>>& jobs) {
+    std::lock_guard<std::mutex> guard(upload_lock);
+    for (auto& job : jobs)
+        upload_jobs.push_back(std::move(job));
+    jobs.clear();
+}
+
+size_t gl_upload_queue::drain(double budget_ms) {
+    auto start = std::chrono::steady_clock::now();
+    size_t ran = 0;
+    while (true) {
+        std::function<void()> job;
+        {
+            std::lock_guard<std::mutex> guard(upload_lock);
+            if (upload_jobs.empty())
+                break;
+            job = std::move(upload_jobs.front());
+            upload_jobs.pop_front();
+        }
+        try {
+            job();
+        } catch (std::exception& e) {
+            std::cerr << "Failed to upload asset data: " << e.what() << "\n";
+        }
+        ran++;
+        if (budget_ms >= 0.0) {
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (elapsed >= budget_ms)
+                break;
+        }
+    }
+    return ran;
+}
+
+size_t gl_upload_queue::pending() {
+    std::lock_guard<std::mutex> guard(upload_lock);
+    return upload_jobs.size();
+}
+
+model_loader::model_loader(string file_path, bool animated) : file_path(file_path), status(std::make_shared<load_status>()) {
+    auto root_mesh_dict = new RC(new mesh_dict());
+    root_mesh_dict->data->name = file_path;
+    result = new RC(new model(root_mesh_dict, animated));
+    result->data->loaded = false;
+
+    // the in flight work holds its own reference so the model outlives this handle if it is dropped early.
+    // it is released by the last job on the gl queue.
+    rc_model in_flight = result;
+    in_flight->inc();
+
+    auto shared_status = status;
+    shared_status->state = LoadState::IMPORTING;
+    import_job = thread_pool::get_global()->submit([shared_status, in_flight, file_path]() {
+        vector<std::function<void()>> uploads;
+        try {
+            mesh::import_into(in_flight, file_path, &uploads);
+        } catch (std::exception& e) {
+            {
+                std::lock_guard<std::mutex> guard(shared_status->error_lock);
+                shared_status->error = e.what();
+            }
+            shared_status->state = LoadState::FAILED;
+            // drop the meshes, materials and animations built before the failure, on the gl thread since their
+            // destructors may touch gl.  The model itself stays, empty, for whoever still holds it.
+            gl_upload_queue::push([in_flight]() {
+                mesh::release_import(in_flight);
+                RC_collect(in_flight);
+            });
+            return;
+        }
+        shared_status->state = LoadState::UPLOADING;
+        uploads.push_back([shared_status, in_flight]() {
+            in_flight->data->loaded = true;
+            shared_status->state = LoadState::READY;
+            RC_collect(in_flight);
+        });
+        gl_upload_queue::push_all(uploads);
+    });
+}
+
+model_loader::~model_loader() {
+    RC_collect(result);
+}
+
+LoadState model_loader::get_state() const {
+    return status->state;
+}
+
+string model_loader::get_error() const {
+    std::lock_guard<std::mutex> guard(status->error_lock);
+    return status->error;
+}
+
+void model_loader::finish() {
+    if (import_job.valid())
+        import_job.wait();
+    while (status->state == LoadState::UPLOADING)
+        gl_upload_queue::drain(-1.0);
+    if (status->state == LoadState::FAILED)
+        throw std::runtime_error(get_error());
+}
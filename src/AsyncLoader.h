@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "RC.h"
+
+using std::string;
+using std::vector;
+
+class model;
+
+typedef RC<model*>* rc_model;
+
+// Queue of gl work produced by worker threads.  Only the thread that owns the gl context may drain it,
+// the window drains it every frame within its upload budget.
+
+class gl_upload_queue {
+public:
+    static void push(std::function<void()> job);
+    static void push_all(vector<std::function<void()>>& jobs);
+    // Runs queued jobs untill the queue is empty or budget_ms has elapsed.  At least one job is always run
+    // so uploads make progress even with a tiny budget.  Jobs are never split, so a frame can overrun the budget
+    // by its longest job (one mesh's buffers or one texture with its mip chain).  A negative budget drains everything.
+    static size_t drain(double budget_ms);
+    static size_t pending();
+};
+
+enum class LoadState {
+    PENDING,
+    IMPORTING,
+    UPLOADING,
+    READY,
+    FAILED
+};
+
+// Handle to a model being loaded in the background.  The assimp import, vertex processing and image decoding
+// run on the global thread_pool, the gl objects are created when the window drains the gl_upload_queue.
+// The model is returned right away but is not rendered untill the upload completes.
+
+class model_loader {
+public:
+    model_loader(string file_path, bool animated);
+    ~model_loader();
+
+    LoadState get_state() const;
+    string get_error() const;
+
+    inline bool is_ready() const {
+        return get_state() == LoadState::READY;
+    }
+
+    // Blocks untill the model is renderable, draining the gl queue on the calling thread.
+    // Must be called from the gl thread.  Throws if the import failed.
+    void finish();
+
+    string file_path;
+    rc_model result = nullptr;
+private:
+    struct load_status {
+        std::atomic<LoadState> state = LoadState::PENDING;
+        mutable std::mutex error_lock;
+        string error;
+    };
+    std::shared_ptr<load_status> status;
+    std::future<void> import_job;
+};
@@ -6,31 +6,24 @@
 #include "Quaternion.h"
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include "util.h"
+#include "ClipCompression.h"
 
 using std::vector;
 using std::string;
 
 // Components of the bone
 
-//// Keyframes
-
-struct key_position {
-    vec3 position = vec3(0.0f);
-    float time_stamp = 0.0f;
-};
-
-struct key_rotation {
-    quaternion orientation = quaternion(1.0f, 0.0f, 0.0f, 0.0f);
-    float time_stamp = 0.0f;
-};
-
-struct key_scale {
-    vec3 scale = vec3(0.0f);
-    float time_stamp = 0.0f;
+// Last key index used per channel.  Forward playback almost always lands on the same key or the next one,
+// so sampling starts from here and only binary searches on seeks and loops.
+struct bone_cursor {
+    int position = 0;
+    int rotation = 0;
+    int scale = 0;
 };
 
 // The bone!
@@ -39,136 +32,198 @@ class bone {
 public:
     string name;
     int id = -1;
-    matrix4x4 local_transform = matrix4x4(1.0f); // This is the transform matrix that all of the lerp'd keyframes are baked into
-    // it is the orientation of the bone in the animation at the current frame.
 private:
-    vector<key_position> positions;
-    vector<key_rotation> rotations;
-    vector<key_scale> scales;
-    int positions_size=0, rotations_size=0, scales_size=0;
+    // keyframes, times are kept apart from values so searching them stays in cache.
+    // values are compressed at import, see clip_compression.
+    vector<float> position_times;
+    vector<quantized_vec3> position_values;
+    quantize_range position_range;
+    vector<float> rotation_times;
+    vector<packed_quat> rotation_values;
+    vector<float> scale_times;
+    vector<quantized_vec3> scale_values;
+    quantize_range scale_range;
 public:
     // constructors
     bone(const string& name, int id, const aiNodeAnim* channel):// aiNodeAnim is the animation data for a bone
         name(name),
-        id(id),
-        local_transform(1.0f)
+        id(id)
     {
+        clip_compression_stats stats;
 
         // POSITION
-        positions_size = channel->mNumPositionKeys;
-        for (int pos_i = 0; pos_i < positions_size; ++pos_i) {
+        vector<float> times;
+        vector<glm::vec3> positions;
+        for (unsigned int pos_i = 0; pos_i < channel->mNumPositionKeys; ++pos_i) {
             aiVector3D ai_pos = channel->mPositionKeys[pos_i].mValue;
-            float time_stamp = (float)channel->mPositionKeys[pos_i].mTime;
-            key_position data = {vec3(ai_pos.x, ai_pos.y, ai_pos.z), time_stamp};
-            positions.push_back(data);
+            times.push_back((float)channel->mPositionKeys[pos_i].mTime);
+            positions.push_back(glm::vec3(ai_pos.x, ai_pos.y, ai_pos.z));
+        }
+        compress_vec3(times, positions, clip_compression::position_tolerance, position_times, position_values, position_range, stats);
+        for (size_t i = 0; i < times.size(); i++) {
+            int cur = 0;
+            stats.max_position_error = std::max(stats.max_position_error, glm::length(interpolate_position(times[i], cur) - positions[i]));
         }
 
         // ROTATION
-        rotations_size = channel->mNumRotationKeys;
-        for (int rot_i = 0; rot_i < rotations_size; ++rot_i) {
+        times.clear();
+        vector<glm::quat> rotations;
+        for (unsigned int rot_i = 0; rot_i < channel->mNumRotationKeys; ++rot_i) {
             aiQuaternion ai_rot = channel->mRotationKeys[rot_i].mValue;
-            float time_stamp = (float)channel->mRotationKeys[rot_i].mTime;
-            key_rotation data = {quaternion(ai_rot.w, ai_rot.x, ai_rot.y, ai_rot.z), time_stamp};
-            rotations.push_back(data);
+            times.push_back((float)channel->mRotationKeys[rot_i].mTime);
+            rotations.push_back(glm::normalize(glm::quat(ai_rot.w, ai_rot.x, ai_rot.y, ai_rot.z)));
+        }
+        auto kept = clip_compression::reduce_keys(times, rotations, clip_compression::rotation_tolerance,
+            [](const glm::quat& a, const glm::quat& b, float t) { return glm::slerp(a, b, t); },
+            [](const glm::quat& a, const glm::quat& b) { return clip_compression::angle_between(a, b); });
+        for (size_t k : kept) {
+            rotation_times.push_back(times[k]);
+            rotation_values.push_back(clip_compression::pack(rotations[k]));
+        }
+        count_channel(times.size(), kept.size(), sizeof(glm::quat), sizeof(packed_quat), 0, stats);
+        for (size_t i = 0; i < times.size(); i++) {
+            int cur = 0;
+            stats.max_rotation_error = std::max(stats.max_rotation_error, clip_compression::angle_between(interpolate_rotation(times[i], cur), rotations[i]));
         }
 
         // SCALE
-        scales_size = channel->mNumScalingKeys;
-        for (int scale_i = 0; scale_i < scales_size; ++scale_i) {
+        times.clear();
+        vector<glm::vec3> scales;
+        for (unsigned int scale_i = 0; scale_i < channel->mNumScalingKeys; ++scale_i) {
             aiVector3D ai_scale = channel->mScalingKeys[scale_i].mValue;
-            float time_stamp = (float)channel->mScalingKeys[scale_i].mTime;
-            key_scale data = {vec3(ai_scale.x, ai_scale.y, ai_scale.z), time_stamp};
-            scales.push_back(data);
+            times.push_back((float)channel->mScalingKeys[scale_i].mTime);
+            scales.push_back(glm::vec3(ai_scale.x, ai_scale.y, ai_scale.z));
+        }
+        compress_vec3(times, scales, clip_compression::scale_tolerance, scale_times, scale_values, scale_range, stats);
+        for (size_t i = 0; i < times.size(); i++) {
+            int cur = 0;
+            stats.max_scale_error = std::max(stats.max_scale_error, glm::length(interpolate_scale(times[i], cur) - scales[i]));
         }
+
+        clip_compression::record(stats);
     }
     // METHODS
 
     //// Helper Functions and Trunks
 
-    inline void update(float animation_time) {
-        // This function updates the whole bone transform.  Acts as a call trunk.
-        matrix4x4 translation = interpolate_position(animation_time);
-        matrix4x4 rotation = interpolate_rotation(animation_time);
-        matrix4x4 scale = interpolate_scale(animation_time);
-        local_transform = translation * rotation * scale;
+    // Returns translation * rotation * scale at animation_time, advancing the cursor.
+    // Bones are shared by every instance playing the clip, so all playback state lives in the caller's cursor.
+    inline glm::mat4 sample(float animation_time, bone_cursor& cur) const {
+        glm::vec3 position = interpolate_position(animation_time, cur.position);
+        glm::quat rotation = interpolate_rotation(animation_time, cur.rotation);
+        glm::vec3 scale = interpolate_scale(animation_time, cur.scale);
+        glm::mat4 ret = glm::mat4_cast(rotation);
+        ret[0] *= scale.x;
+        ret[1] *= scale.y;
+        ret[2] *= scale.z;
+        ret[3] = glm::vec4(position, 1.0f);
+        return ret;
     }
 
-    inline int get_position_index(float animation_time) {
-        // itterates all positions untill it finds a keyframe with a higher timestamp than the current time
-        for (int i = 0; i < positions_size - 1; ++i) {
-            if (animation_time < positions[i + 1].time_stamp)
-                return i;
-        }
-        return positions_size-2;
+    inline size_t key_count() const {
+        return position_times.size() + rotation_times.size() + scale_times.size();
     }
 
-    inline int get_rotation_index(float animation_time) {
-        // itterates all rotations untill it finds a keyframe with a higher timestamp than the current time
-        for (int i = 0; i < rotations_size - 1; ++i) {
-            if (animation_time < rotations[i + 1].time_stamp)
+    // Finds the key that starts the segment containing animation_time.  Checks the cached key and the
+    // next few first, then falls back to a binary search.
+    static inline int find_key(const vector<float>& times, float animation_time, int& cur) {
+        int last = static_cast<int>(times.size()) - 2;
+        int i = std::clamp(cur, 0, last);
+        if (animation_time >= times[i]) {
+            for (int steps = 0; steps < 4 && i < last && animation_time >= times[i + 1]; steps++)
+                i++;
+            if (i == last || animation_time < times[i + 1]) {
+                cur = i;
                 return i;
+            }
         }
-        return rotations_size-2;
-    }
-
-    inline int get_scale_index(float animation_time) {
-        // itterates all scales untill it finds a keyframe with a higher timestamp than the current time
-        for (int i = 0; i < scales_size - 1; ++i) {
-            if (animation_time < scales[i + 1].time_stamp)
-                return i;
-        }
-        return scales_size-2;
+        auto next = std::upper_bound(times.begin(), times.end(), animation_time);
+        i = std::clamp(static_cast<int>(next - times.begin()) - 1, 0, last);
+        cur = i;
+        return i;
     }
 
 private:
     // THE MEAT
 
-    inline float get_scale_factor(float prev_time_stamp, float next_time_stamp, float animation_time) {
+    static inline float get_scale_factor(float prev_time_stamp, float next_time_stamp, float animation_time) {
         // returns the time to reach the next frame as a ratio between 0.0 and 1.0
-        float scale_factor = 0.0f;
         float mid_way_len = animation_time - prev_time_stamp;// this is how far it has traveled between prev and next
         float transition_len = next_time_stamp - prev_time_stamp;
-        scale_factor = mid_way_len / transition_len;// creates a ratio ie: interpolates the distance to the next keyframe between 0.0 and 1.0
-        return scale_factor;
+        // creates a ratio ie: interpolates the distance to the next keyframe between 0.0 and 1.0
+        return transition_len > 0.0f ? mid_way_len / transition_len : 0.0f;
     }
 
-    inline matrix4x4 interpolate_position(float animation_time) {
+    inline glm::vec3 interpolate_position(float animation_time, int& cur) const {
         // interpolates the position between the prev and next keyframe position
-        if (positions_size == 1)
-            return matrix4x4(1.0f).translate(positions[0].position);
-        
-        int pos_0_i = get_position_index(animation_time);
-        int pos_1_i = pos_0_i + 1;
-        float scale_factor = get_scale_factor(positions[pos_0_i].time_stamp, positions[pos_1_i].time_stamp, animation_time);
-        vec3 final_position = positions[pos_0_i].position.lerp(positions[pos_1_i].position, scale_factor);
-        return matrix4x4(1.0f).translate(final_position);
+        if (position_times.size() <= 1)
+            return position_times.empty() ? glm::vec3(0.0f) : clip_compression::dequantize(position_values[0], position_range);
+
+        int pos_0_i = find_key(position_times, animation_time, cur);
+        float scale_factor = get_scale_factor(position_times[pos_0_i], position_times[pos_0_i + 1], animation_time);
+        return glm::mix(
+            clip_compression::dequantize(position_values[pos_0_i], position_range),
+            clip_compression::dequantize(position_values[pos_0_i + 1], position_range),
+            scale_factor
+        );
     }
 
-    inline matrix4x4 interpolate_rotation(float animation_time) {
+    inline glm::quat interpolate_rotation(float animation_time, int& cur) const {
         // interpolates the rotation between the prev and next keyframe rotation
-        if (rotations_size == 1) {
-            auto rot = rotations[0].orientation.get_normalized();
-            return matrix4x4(rot);
-        }
-
-        int rot_0_i = get_rotation_index(animation_time);
-        int rot_1_i = rot_0_i + 1;
-        float scale_factor = get_scale_factor(rotations[rot_0_i].time_stamp, rotations[rot_1_i].time_stamp, animation_time);
-        quaternion final_rot = rotations[rot_0_i].orientation.slerp(rotations[rot_1_i].orientation, scale_factor);
-        final_rot = final_rot.get_normalized();
-        return matrix4x4(final_rot);
+        if (rotation_times.size() <= 1)
+            return rotation_times.empty() ? glm::quat(1.0f, 0.0f, 0.0f, 0.0f) : clip_compression::unpack(rotation_values[0]);
+
+        int rot_0_i = find_key(rotation_times, animation_time, cur);
+        float scale_factor = get_scale_factor(rotation_times[rot_0_i], rotation_times[rot_0_i + 1], animation_time);
+        // slerp takes the short way round, packed keys may have flipped signs.
+        return glm::normalize(glm::slerp(
+            clip_compression::unpack(rotation_values[rot_0_i]),
+            clip_compression::unpack(rotation_values[rot_0_i + 1]),
+            scale_factor
+        ));
     }
 
-    inline matrix4x4 interpolate_scale(float animation_time) {
+    inline glm::vec3 interpolate_scale(float animation_time, int& cur) const {
         // interpolates the scale between the prev and next keyframe scale
-        if (scales_size == 1)
-            return matrix4x4(1.0f).scale(scales[0].scale);
-
-        int pos_0_i = get_scale_index(animation_time);
-        int pos_1_i = pos_0_i + 1;
-        float scale_factor = get_scale_factor(scales[pos_0_i].time_stamp, scales[pos_1_i].time_stamp, animation_time);
-        vec3 final_scale = scales[pos_0_i].scale.lerp(scales[pos_1_i].scale, scale_factor);
-        return matrix4x4(1.0f).scale(final_scale);
+        if (scale_times.size() <= 1)
+            return scale_times.empty() ? glm::vec3(1.0f) : clip_compression::dequantize(scale_values[0], scale_range);
+
+        int scl_0_i = find_key(scale_times, animation_time, cur);
+        float scale_factor = get_scale_factor(scale_times[scl_0_i], scale_times[scl_0_i + 1], animation_time);
+        return glm::mix(
+            clip_compression::dequantize(scale_values[scl_0_i], scale_range),
+            clip_compression::dequantize(scale_values[scl_0_i + 1], scale_range),
+            scale_factor
+        );
+    }
+
+    //// Compression
+
+    static inline void compress_vec3(const vector<float>& times, const vector<glm::vec3>& values, float tolerance,
+        vector<float>& out_times, vector<quantized_vec3>& out_values, quantize_range& range, clip_compression_stats& stats)
+    {
+        auto kept = clip_compression::reduce_keys(times, values, tolerance,
+            [](const glm::vec3& a, const glm::vec3& b, float t) { return glm::mix(a, b, t); },
+            [](const glm::vec3& a, const glm::vec3& b) { return glm::length(a - b); });
+        vector<glm::vec3> kept_values;
+        for (size_t k : kept)
+            kept_values.push_back(values[k]);
+        range = clip_compression::make_range(kept_values);
+        for (size_t i = 0; i < kept.size(); i++) {
+            out_times.push_back(times[kept[i]]);
+            out_values.push_back(clip_compression::quantize(kept_values[i], range));
+        }
+        count_channel(times.size(), kept.size(), sizeof(glm::vec3), sizeof(quantized_vec3), sizeof(quantize_range), stats);
+    }
+
+    static inline void count_channel(size_t source_keys, size_t kept_keys, size_t source_value, size_t packed_value, size_t extra, clip_compression_stats& stats) {
+        stats.channels++;
+        if (kept_keys == 1)
+            stats.constant_channels++;
+        stats.source_keys += source_keys;
+        stats.kept_keys += kept_keys;
+        stats.source_bytes += source_keys * (sizeof(float) + source_value);
+        stats.compressed_bytes += kept_keys * (sizeof(float) + packed_value) + extra;
     }
 
 };
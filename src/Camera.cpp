@@ -2,6 +2,7 @@
 #include "Vec3.h"
 #include "Object3d.h"
 #include <algorithm>
+#include <cmath>
 
 
 camera::camera() {}
@@ -20,6 +21,43 @@ camera::camera(vec3* position, quaternion* rotation, int view_width, int view_he
     this->view = glm::lookAt(this->position->axis, this->position->axis + this->rotation->get_forward().axis, this->rotation->get_up().axis);
 }
 
+// world space bounding sphere of a model space aabb.
+static void bounding_sphere(const matrix4x4& model_matrix, const vec3& aabb_min, const vec3& aabb_max, glm::vec3& center, float& radius) {
+    center = glm::vec3(model_matrix.mat * glm::vec4((aabb_min.axis + aabb_max.axis) * 0.5f, 1.0f));
+    float scale = std::max({
+        glm::length(glm::vec3(model_matrix.mat[0])),
+        glm::length(glm::vec3(model_matrix.mat[1])),
+        glm::length(glm::vec3(model_matrix.mat[2]))
+    });
+    radius = glm::length(aabb_max.axis - aabb_min.axis) * 0.5f * scale;
+}
+
+float camera::screen_size(const matrix4x4& model_matrix, const vec3& aabb_min, const vec3& aabb_max) const {
+    glm::vec3 center;
+    float radius;
+    bounding_sphere(model_matrix, aabb_min, aabb_max, center, radius);
+    float distance = glm::length(center - this->position->axis);
+    if (distance <= radius)
+        return static_cast<float>(this->view_height);
+    return radius / (distance * std::tan(this->fov * 0.5f)) * this->view_height;
+}
+
+bool camera::in_view(const matrix4x4& model_matrix, const vec3& aabb_min, const vec3& aabb_max) const {
+    glm::vec3 center;
+    float radius;
+    bounding_sphere(model_matrix, aabb_min, aabb_max, center, radius);
+    // frustum planes straight from the rows of projection * view.
+    glm::mat4 pv = glm::transpose(this->projection.mat * this->view.mat);
+    for (int i = 0; i < 3; i++) {
+        for (float side : {1.0f, -1.0f}) {
+            glm::vec4 plane = pv[3] + side * pv[i];
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius * glm::length(glm::vec3(plane)))
+                return false;
+        }
+    }
+    return true;
+}
+
 void camera::recalculate_pv() {
     this->projection = glm::perspective(this->fov, static_cast<float>(this->view_width)/static_cast<float>(this->view_height), 0.1f, static_cast<float>(this->focal_length));
     this->view = glm::lookAt(this->position->axis, this->position->axis + this->rotation->get_forward().axis, this->rotation->get_up().axis);
@@ -25,6 +25,10 @@ public:
     float focal_length;
     float fov;
     void recalculate_pv();
+    // projected diameter in pixels of the aabb (in model space) drawn with model_matrix.
+    float screen_size(const matrix4x4& model_matrix, const vec3& aabb_min, const vec3& aabb_max) const;
+    // false when the bounding sphere of the aabb is entirely outside the view frustum.
+    bool in_view(const matrix4x4& model_matrix, const vec3& aabb_min, const vec3& aabb_max) const;
     matrix4x4 projection, view;
     double * deltatime;
     long long * time_ns;
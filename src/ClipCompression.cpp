@@ -0,0 +1,30 @@
+#include "ClipCompression.h"
+
+float clip_compression::position_tolerance = 0.0001f;
+float clip_compression::rotation_tolerance = 0.0001f;
+float clip_compression::scale_tolerance = 0.0001f;
+clip_compression_stats clip_compression::stats;
+std::mutex clip_compression::lock;
+
+clip_compression_stats clip_compression::get_stats() {
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+}
+
+void clip_compression::reset_stats() {
+    std::lock_guard<std::mutex> guard(lock);
+    stats = clip_compression_stats();
+}
+
+void clip_compression::record(const clip_compression_stats& channel) {
+    std::lock_guard<std::mutex> guard(lock);
+    stats.channels += channel.channels;
+    stats.constant_channels += channel.constant_channels;
+    stats.source_keys += channel.source_keys;
+    stats.kept_keys += channel.kept_keys;
+    stats.source_bytes += channel.source_bytes;
+    stats.compressed_bytes += channel.compressed_bytes;
+    stats.max_position_error = std::max(stats.max_position_error, channel.max_position_error);
+    stats.max_rotation_error = std::max(stats.max_rotation_error, channel.max_rotation_error);
+    stats.max_scale_error = std::max(stats.max_scale_error, channel.max_scale_error);
+}
@@ -0,0 +1,177 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+using std::vector;
+
+// 16 bits per axis against a per channel range.  (see quantize_range)
+struct quantized_vec3 {
+    uint16_t x = 0, y = 0, z = 0;
+};
+
+// Smallest three quaternion in 48 bits.  The largest component is dropped (and rebuilt from the unit length),
+// its index goes in the top bits of the first two words and the other three are stored with 15 bits each.
+struct packed_quat {
+    uint16_t bits[3] = {0, 0, 0};
+};
+
+struct quantize_range {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 step = glm::vec3(0.0f);
+};
+
+struct clip_compression_stats {
+    size_t channels = 0;
+    // channels stored as a single key.
+    size_t constant_channels = 0;
+    size_t source_keys = 0;
+    size_t kept_keys = 0;
+    // keys at full precision (float time and glm value) against what is stored after compression.
+    size_t source_bytes = 0;
+    size_t compressed_bytes = 0;
+    // largest difference between a source key and the compressed channel sampled at its time.
+    float max_position_error = 0.0f;
+    float max_rotation_error = 0.0f; // radians
+    float max_scale_error = 0.0f;
+};
+
+// Import time compression of animation channels, used by bone.
+// Keys that linear interpolation of their neighbours reproduces within a tolerance are removed, channels that
+// stay within the tolerance of their first key keep only that key, rotations are packed into 48 bits and
+// positions and scales are quantized to 16 bits per axis against the channel's range.
+
+class clip_compression {
+public:
+    // largest error a removed key may have, in model units, radians and scale factor.
+    static float position_tolerance, rotation_tolerance, scale_tolerance;
+    static inline void set_tolerances(float position, float rotation, float scale) {
+        position_tolerance = position;
+        rotation_tolerance = rotation;
+        scale_tolerance = scale;
+    }
+
+    // stats summed over every channel compressed so far.
+    static clip_compression_stats get_stats();
+    static void reset_stats();
+    // adds one channel's numbers to the totals, called by bone.  Thread safe.
+    static void record(const clip_compression_stats& channel);
+
+    // longest run of keys one interpolated segment may replace.
+    static constexpr size_t MAX_RUN_KEYS = 64;
+
+    // indices of the keys to keep.  lerp(a, b, t) interpolates two values, error(a, b) measures their difference.
+    template<typename T, typename Lerp, typename Error>
+    static vector<size_t> reduce_keys(const vector<float>& times, const vector<T>& values, float tolerance, Lerp lerp, Error error) {
+        size_t count = times.size();
+        vector<size_t> kept;
+        if (count == 0)
+            return kept;
+        bool constant = true;
+        for (size_t i = 1; i < count && constant; i++)
+            constant = error(values[0], values[i]) <= tolerance;
+        kept.push_back(0);
+        if (constant)
+            return kept;
+
+        // grow a run from the last kept key for as long as every key inside it can be interpolated.  Runs are cut
+        // at MAX_RUN_KEYS so long linear stretches cost O(n * MAX_RUN_KEYS) instead of O(n^2), at the price of
+        // one extra key per cut.
+        size_t anchor = 0;
+        for (size_t end = 2; end < count; end++) {
+            float span = times[end] - times[anchor];
+            bool fits = end - anchor <= MAX_RUN_KEYS;
+            for (size_t k = anchor + 1; k < end && fits; k++) {
+                float t = span > 0.0f ? (times[k] - times[anchor]) / span : 0.0f;
+                fits = error(lerp(values[anchor], values[end], t), values[k]) <= tolerance;
+            }
+            if (!fits) {
+                anchor = end - 1;
+                kept.push_back(anchor);
+            }
+        }
+        if (count > 1)
+            kept.push_back(count - 1);
+        return kept;
+    }
+
+    static inline quantize_range make_range(const vector<glm::vec3>& values) {
+        quantize_range ret;
+        if (values.empty())
+            return ret;
+        glm::vec3 low = values[0], high = values[0];
+        for (const auto& v : values) {
+            low = glm::min(low, v);
+            high = glm::max(high, v);
+        }
+        ret.min = low;
+        ret.step = (high - low) / 65535.0f;
+        return ret;
+    }
+
+    static inline quantized_vec3 quantize(const glm::vec3& value, const quantize_range& range) {
+        quantized_vec3 ret;
+        uint16_t* out[3] = {&ret.x, &ret.y, &ret.z};
+        for (int i = 0; i < 3; i++) {
+            float q = range.step[i] > 0.0f ? (value[i] - range.min[i]) / range.step[i] : 0.0f;
+            *out[i] = static_cast<uint16_t>(std::clamp(std::lround(q), 0l, 65535l));
+        }
+        return ret;
+    }
+
+    static inline glm::vec3 dequantize(const quantized_vec3& value, const quantize_range& range) {
+        return range.min + glm::vec3(value.x, value.y, value.z) * range.step;
+    }
+
+    static inline packed_quat pack(glm::quat q) {
+        q = glm::normalize(q);
+        float c[4] = {q.x, q.y, q.z, q.w};
+        int largest = 0;
+        for (int i = 1; i < 4; i++)
+            if (std::abs(c[i]) > std::abs(c[largest]))
+                largest = i;
+        // q and -q are the same rotation, flip so the dropped component is positive.
+        float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+        uint16_t small[3];
+        for (int i = 0, j = 0; i < 4; i++) {
+            if (i == largest)
+                continue;
+            float v = c[i] * sign * SQRT2 * 0.5f + 0.5f;
+            small[j++] = static_cast<uint16_t>(std::clamp(std::lround(v * 32767.0f), 0l, 32767l));
+        }
+        packed_quat ret;
+        ret.bits[0] = static_cast<uint16_t>(((largest >> 1) << 15) | small[0]);
+        ret.bits[1] = static_cast<uint16_t>(((largest & 1) << 15) | small[1]);
+        ret.bits[2] = small[2];
+        return ret;
+    }
+
+    static inline glm::quat unpack(const packed_quat& p) {
+        int largest = ((p.bits[0] >> 15) << 1) | (p.bits[1] >> 15);
+        float small[3];
+        float sum = 0.0f;
+        for (int i = 0; i < 3; i++) {
+            small[i] = ((p.bits[i] & 0x7fff) / 32767.0f - 0.5f) * 2.0f / SQRT2;
+            sum += small[i] * small[i];
+        }
+        float c[4];
+        for (int i = 0, j = 0; i < 4; i++)
+            c[i] = i == largest ? std::sqrt(std::max(0.0f, 1.0f - sum)) : small[j++];
+        return glm::quat(c[3], c[0], c[1], c[2]);
+    }
+
+    // angle in radians between two rotations.
+    static inline float angle_between(const glm::quat& a, const glm::quat& b) {
+        float d = std::min(1.0f, std::abs(glm::dot(a, b)));
+        return 2.0f * std::acos(d);
+    }
+private:
+    static constexpr float SQRT2 = 1.41421356f;
+    static clip_compression_stats stats;
+    static std::mutex lock;
+};
@@ -88,6 +88,26 @@ collider_box::collider_box(object3d* owner, vec3* offset, quaternion* rotation,
     dbg_create_shader_program();
 }
 
+void collider_box::refit(const vector<glm::vec3>& points) {
+    if (points.empty())
+        return;
+    glm::vec3 high = points[0], low = points[0];
+    for (const auto& p : points) {
+        high = glm::max(high, p);
+        low = glm::min(low, p);
+    }
+    this->upper_bounds = vec3(high);
+    this->lower_bounds = vec3(low);
+    this->bounds[0] = upper_bounds;
+    this->bounds[1] = vec3(lower_bounds.axis.x, upper_bounds.axis.y, upper_bounds.axis.z);
+    this->bounds[2] = vec3(lower_bounds.axis.x, lower_bounds.axis.y, upper_bounds.axis.z);
+    this->bounds[3] = vec3(upper_bounds.axis.x, lower_bounds.axis.y, upper_bounds.axis.z);
+    this->bounds[4] = lower_bounds;
+    this->bounds[5] = vec3(upper_bounds.axis.x, lower_bounds.axis.y, lower_bounds.axis.z);
+    this->bounds[6] = vec3(upper_bounds.axis.x, upper_bounds.axis.y, lower_bounds.axis.z);
+    this->bounds[7] = vec3(lower_bounds.axis.x, upper_bounds.axis.y, lower_bounds.axis.z);
+}
+
 void collider_box::mutate_max_min(mesh_dict* m_d, vec3* aabb_max, vec3* aabb_min) {
     for (auto [_, m] : *m_d) {
         if (std::holds_alternative<rc_mesh>(m)) {
@@ -384,6 +404,15 @@ collider_convex::collider_convex(rc_mesh_dict owner, vec3* offset, quaternion* r
     this->scale = scale;
 }
 
+void collider_convex::refit(const vector<glm::vec3>& points) {
+    vector<vec3> verts;
+    verts.reserve(points.size());
+    for (const auto& p : points)
+        verts.push_back(vec3(p));
+    hull.clear();
+    generate_hull(verts);
+}
+
 void collider_convex::render_hull_extract_edges() {
     vector<vec3> uniqueVertices;
 
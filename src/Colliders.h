@@ -72,6 +72,9 @@ public:
     void dbg_render(const camera& cam) override;
 
     std::pair<float, float> minmax_vertex_SAT(const vec3 & axis) override;
+    // moves the box to tightly fit points, used to follow skinned meshes. (see object3d::refit_colliders)
+    // The debug outline keeps the original shape.
+    void refit(const vector<glm::vec3>& points);
     vec3 upper_bounds;
     vec3 lower_bounds;
     vec3 bounds[8];
@@ -165,6 +168,9 @@ public:
     bool check_collision(collider_convex* collider);
 
     std::pair<float, float> minmax_vertex_SAT(const vec3 & axis) override;
+    // rebuilds the hull around points, used to follow skinned meshes. (see object3d::refit_colliders)
+    // The debug outline keeps the original shape.
+    void refit(const vector<glm::vec3>& points);
     vector<hull_face> hull;
 
     // DEBUG
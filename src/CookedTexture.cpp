@@ -0,0 +1,463 @@
+#include "CookedTexture.h"
+#include <stb_image.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const char COOKED_MAGIC[4] = {'L', 'X', 'T', 'C'};
+static const uint32_t COOKED_VERSION = 1;
+
+struct cooked_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t level_count;
+    uint32_t reserved[2];
+};
+static_assert(sizeof(cooked_header) == 32, "cooked_header must match the on disk layout");
+static_assert(sizeof(cooked_level) == 24, "cooked_level must match the on disk layout");
+
+bool cooked_texture::prefer_cooked = true;
+
+static size_t block_bytes(CookedFormat format) {
+    return format == CookedFormat::BC1 ? 8 : 16;
+}
+
+static size_t level_size(CookedFormat format, uint32_t width, uint32_t height) {
+    if (format == CookedFormat::RGBA8)
+        return static_cast<size_t>(width) * height * 4;
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * block_bytes(format);
+}
+
+// 2x2 box filter, odd edges reuse the last row or column.
+static vector<unsigned char> downsample(const vector<unsigned char>& rgba, uint32_t width, uint32_t height, uint32_t& out_width, uint32_t& out_height) {
+    out_width = std::max(1u, width / 2);
+    out_height = std::max(1u, height / 2);
+    vector<unsigned char> ret(static_cast<size_t>(out_width) * out_height * 4);
+    for (uint32_t y = 0; y < out_height; y++) {
+        uint32_t y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+        for (uint32_t x = 0; x < out_width; x++) {
+            uint32_t x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+            for (int c = 0; c < 4; c++) {
+                unsigned sum = rgba[(static_cast<size_t>(y0) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y0) * width + x1) * 4 + c]
+                    + rgba[(static_cast<size_t>(y1) * width + x0) * 4 + c] + rgba[(static_cast<size_t>(y1) * width + x1) * 4 + c];
+                ret[(static_cast<size_t>(y) * out_width + x) * 4 + c] = static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+    return ret;
+}
+
+cooked_texture::cooked_texture(const unsigned char* pixels, int width, int height, int channels) : width(width), height(height) {
+    vector<unsigned char> rgba(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        for (int c = 0; c < 4; c++)
+            rgba[i * 4 + c] = c < channels ? pixels[i * channels + c] : 255;
+    }
+
+    uint32_t level_w = width, level_h = height;
+    while (true) {
+        cooked_level level;
+        level.width = level_w;
+        level.height = level_h;
+        level.offset = owned.size();
+        level.size = rgba.size();
+        owned.insert(owned.end(), rgba.begin(), rgba.end());
+        levels.push_back(level);
+        if (level_w == 1 && level_h == 1)
+            break;
+        rgba = downsample(rgba, level_w, level_h, level_w, level_h);
+    }
+    data = owned.data();
+    data_size = owned.size();
+}
+
+cooked_texture::cooked_texture(const string& file_path) : file_path(file_path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Could not open cooked texture: " + file_path);
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        throw std::runtime_error("Could not map cooked texture: " + file_path);
+    }
+    data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    data_size = static_cast<size_t>(size.QuadPart);
+    file_handle = file;
+    mapping_handle = mapping;
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Could not map cooked texture: " + file_path);
+    }
+#else
+    int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Could not open cooked texture: " + file_path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        throw std::runtime_error("Could not read cooked texture: " + file_path);
+    }
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        throw std::runtime_error("Could not map cooked texture: " + file_path);
+    data = static_cast<const unsigned char*>(mapped);
+    data_size = static_cast<size_t>(st.st_size);
+#endif
+
+    auto malformed = [&](const string& reason) {
+        string message = "Malformed cooked texture \"" + file_path + "\": " + reason;
+        unmap();
+        throw std::runtime_error(message);
+    };
+
+    if (data_size < sizeof(cooked_header))
+        malformed("file too small");
+    cooked_header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, COOKED_MAGIC, 4) != 0)
+        malformed("bad magic");
+    if (header.version != COOKED_VERSION)
+        malformed("unsupported version " + std::to_string(header.version));
+    if (header.format > static_cast<uint32_t>(CookedFormat::BC5))
+        malformed("unknown format");
+    if (header.level_count == 0 || header.level_count > 32)
+        malformed("bad level count");
+    if (sizeof(cooked_header) + header.level_count * sizeof(cooked_level) > data_size)
+        malformed("truncated level table");
+
+    format = static_cast<CookedFormat>(header.format);
+    width = header.width;
+    height = header.height;
+    levels.resize(header.level_count);
+    std::memcpy(levels.data(), data + sizeof(cooked_header), header.level_count * sizeof(cooked_level));
+    for (auto& level : levels) {
+        if (level.offset + level.size > data_size || level.size != level_size(format, level.width, level.height))
+            malformed("bad level entry");
+    }
+}
+
+cooked_texture::~cooked_texture() {
+    unmap();
+}
+
+void cooked_texture::unmap() {
+    if (!data)
+        return;
+    if (!owned.empty()) {
+        owned.clear();
+        data = nullptr;
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(const_cast<unsigned char*>(data));
+    CloseHandle(static_cast<HANDLE>(mapping_handle));
+    CloseHandle(static_cast<HANDLE>(file_handle));
+#else
+    munmap(const_cast<unsigned char*>(data), data_size);
+#endif
+    data = nullptr;
+}
+
+const unsigned char* cooked_texture::level_data(size_t level) const {
+    return data + levels[level].offset;
+}
+
+size_t cooked_texture::byte_size() const {
+    return byte_size(0);
+}
+
+size_t cooked_texture::byte_size(size_t first_level) const {
+    size_t ret = 0;
+    for (size_t i = first_level; i < levels.size(); i++)
+        ret += levels[i].size;
+    return ret;
+}
+
+bool cooked_texture::is_compressed() const {
+    return format != CookedFormat::RGBA8;
+}
+
+GLenum cooked_texture::gl_internal_format() const {
+    switch (format) {
+        case CookedFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case CookedFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case CookedFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+        default: return GL_RGBA8;
+    }
+}
+
+void cooked_texture::upload_levels(GLenum target, size_t first_level) const {
+    for (size_t i = first_level; i < levels.size(); i++) {
+        auto& level = levels[i];
+        GLint gl_level = static_cast<GLint>(i - first_level);
+        if (is_compressed())
+            glCompressedTexImage2D(target, gl_level, gl_internal_format(), level.width, level.height, 0,
+                static_cast<GLsizei>(level.size), level_data(i));
+        else
+            glTexImage2D(target, gl_level, GL_RGBA8, level.width, level.height, 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, level_data(i));
+    }
+}
+
+bool cooked_texture::format_supported(CookedFormat format) {
+    switch (format) {
+        case CookedFormat::BC1:
+        case CookedFormat::BC3:
+            return GLAD_GL_EXT_texture_compression_s3tc;
+        default: // RGTC is core since gl 3.0
+            return true;
+    }
+}
+
+string cooked_texture::cooked_path(const string& source_path) {
+    return fs::path(source_path).replace_extension(".lxt").string();
+}
+
+string cooked_texture::find_cooked(const string& source_path) {
+    std::error_code ec;
+    fs::path source(source_path);
+    if (source.extension() == ".lxt")
+        return source_path;
+    if (!prefer_cooked)
+        return "";
+
+    fs::path cooked = cooked_path(source_path);
+    if (!fs::exists(cooked, ec))
+        return "";
+    if (fs::exists(source, ec) && fs::last_write_time(source, ec) > fs::last_write_time(cooked, ec))
+        return ""; // the source was edited after cooking.
+
+    std::ifstream file(cooked, std::ios::binary);
+    cooked_header header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, COOKED_MAGIC, 4) != 0)
+        return "";
+    if (!format_supported(static_cast<CookedFormat>(header.format)))
+        return "";
+    return cooked.string();
+}
+
+// Block encoders.  These favour simplicity over quality: endpoints are the extremes of each block along its
+// principal axis (colors) or its range (single channels), no iterative refinement.
+
+static uint16_t to_565(const float c[3]) {
+    auto q = [](float v, int bits) {
+        int max = (1 << bits) - 1;
+        return std::clamp(static_cast<int>(std::lround(v / 255.0f * max)), 0, max);
+    };
+    return static_cast<uint16_t>((q(c[0], 5) << 11) | (q(c[1], 6) << 5) | q(c[2], 5));
+}
+
+static void from_565(uint16_t c, float out[3]) {
+    int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = static_cast<float>((r << 3) | (r >> 2));
+    out[1] = static_cast<float>((g << 2) | (g >> 4));
+    out[2] = static_cast<float>((b << 3) | (b >> 2));
+}
+
+static void encode_color_block(const unsigned char px[16][4], unsigned char* out) {
+    float mean[3] = {0, 0, 0};
+    for (int i = 0; i < 16; i++)
+        for (int c = 0; c < 3; c++)
+            mean[c] += px[i][c] / 16.0f;
+
+    float cov[6] = {0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 16; i++) {
+        float r = px[i][0] - mean[0], g = px[i][1] - mean[1], b = px[i][2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int iter = 0; iter < 4; iter++) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float len = std::max({std::fabs(x), std::fabs(y), std::fabs(z)});
+        if (len < 1e-6f)
+            break;
+        axis[0] = x / len; axis[1] = y / len; axis[2] = z / len;
+    }
+
+    int min_i = 0, max_i = 0;
+    float min_p = 1e30f, max_p = -1e30f;
+    for (int i = 0; i < 16; i++) {
+        float p = px[i][0] * axis[0] + px[i][1] * axis[1] + px[i][2] * axis[2];
+        if (p < min_p) { min_p = p; min_i = i; }
+        if (p > max_p) { max_p = p; max_i = i; }
+    }
+    float max_c[3] = {float(px[max_i][0]), float(px[max_i][1]), float(px[max_i][2])};
+    float min_c[3] = {float(px[min_i][0]), float(px[min_i][1]), float(px[min_i][2])};
+    uint16_t c0 = to_565(max_c), c1 = to_565(min_c);
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        // c0 > c1 selects the four color mode in both BC1 and BC3.
+        float palette[4][3];
+        from_565(c0, palette[0]);
+        from_565(c1, palette[1]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+            palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+        }
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            float best_dist = 1e30f;
+            for (int p = 0; p < 4; p++) {
+                float dr = px[i][0] - palette[p][0], dg = px[i][1] - palette[p][1], db = px[i][2] - palette[p][2];
+                float dist = dr * dr + dg * dg + db * db;
+                if (dist < best_dist) { best_dist = dist; best = p; }
+            }
+            indices |= static_cast<uint32_t>(best) << (i * 2);
+        }
+    }
+    out[0] = c0 & 0xff; out[1] = c0 >> 8;
+    out[2] = c1 & 0xff; out[3] = c1 >> 8;
+    for (int b = 0; b < 4; b++)
+        out[4 + b] = (indices >> (b * 8)) & 0xff;
+}
+
+static void encode_channel_block(const unsigned char px[16][4], int channel, unsigned char* out) {
+    unsigned char a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; i++) {
+        a0 = std::max(a0, px[i][channel]);
+        a1 = std::min(a1, px[i][channel]);
+    }
+    out[0] = a0;
+    out[1] = a1;
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        // a0 > a1 selects the eight value mode.
+        float palette[8];
+        palette[0] = a0;
+        palette[1] = a1;
+        for (int p = 2; p < 8; p++)
+            palette[p] = ((8 - p) * a0 + (p - 1) * a1) / 7.0f;
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            float best_dist = 1e30f;
+            for (int p = 0; p < 8; p++) {
+                float dist = std::fabs(px[i][channel] - palette[p]);
+                if (dist < best_dist) { best_dist = dist; best = p; }
+            }
+            indices |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+    for (int b = 0; b < 6; b++)
+        out[2 + b] = (indices >> (b * 8)) & 0xff;
+}
+
+static vector<unsigned char> encode_level(const vector<unsigned char>& rgba, uint32_t width, uint32_t height, CookedFormat format) {
+    if (format == CookedFormat::RGBA8)
+        return rgba;
+    vector<unsigned char> ret(level_size(format, width, height));
+    size_t blocks_x = (width + 3) / 4, blocks_y = (height + 3) / 4;
+    unsigned char* out = ret.data();
+    for (size_t by = 0; by < blocks_y; by++) {
+        for (size_t bx = 0; bx < blocks_x; bx++) {
+            // edge blocks repeat the last row and column.
+            unsigned char px[16][4];
+            for (size_t j = 0; j < 4; j++) {
+                size_t y = std::min<size_t>(by * 4 + j, height - 1);
+                for (size_t i = 0; i < 4; i++) {
+                    size_t x = std::min<size_t>(bx * 4 + i, width - 1);
+                    std::memcpy(px[j * 4 + i], &rgba[(y * width + x) * 4], 4);
+                }
+            }
+            switch (format) {
+                case CookedFormat::BC1:
+                    encode_color_block(px, out);
+                    break;
+                case CookedFormat::BC3:
+                    encode_channel_block(px, 3, out);
+                    encode_color_block(px, out + 8);
+                    break;
+                case CookedFormat::BC5:
+                    encode_channel_block(px, 0, out);
+                    encode_channel_block(px, 1, out + 8);
+                    break;
+                default:
+                    break;
+            }
+            out += block_bytes(format);
+        }
+    }
+    return ret;
+}
+
+void cooked_texture::cook(const string& source_path, const string& out_path, CookedFormat format, bool generate_mips) {
+    int w, h, channels;
+    unsigned char* pixels = stbi_load(source_path.c_str(), &w, &h, &channels, 4);
+    if (!pixels)
+        throw std::runtime_error("Failed to load texture at \"" + source_path + "\"\nSTBI log: " + stbi_failure_reason());
+    vector<unsigned char> rgba(pixels, pixels + static_cast<size_t>(w) * h * 4);
+    stbi_image_free(pixels);
+
+    vector<cooked_level> table;
+    vector<vector<unsigned char>> payloads;
+    uint32_t level_w = w, level_h = h;
+    while (true) {
+        cooked_level level;
+        level.width = level_w;
+        level.height = level_h;
+        payloads.push_back(encode_level(rgba, level_w, level_h, format));
+        level.size = payloads.back().size();
+        table.push_back(level);
+        if (!generate_mips || (level_w == 1 && level_h == 1))
+            break;
+        rgba = downsample(rgba, level_w, level_h, level_w, level_h);
+    }
+
+    uint64_t offset = sizeof(cooked_header) + table.size() * sizeof(cooked_level);
+    for (auto& level : table) {
+        offset = (offset + 15) & ~uint64_t(15);
+        level.offset = offset;
+        offset += level.size;
+    }
+
+    cooked_header header = {};
+    std::memcpy(header.magic, COOKED_MAGIC, 4);
+    header.version = COOKED_VERSION;
+    header.format = static_cast<uint32_t>(format);
+    header.width = w;
+    header.height = h;
+    header.level_count = static_cast<uint32_t>(table.size());
+
+    std::ofstream file(out_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        throw std::runtime_error("Could not write cooked texture: " + out_path);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(cooked_level));
+    uint64_t written = sizeof(cooked_header) + table.size() * sizeof(cooked_level);
+    static const char padding[16] = {};
+    for (size_t i = 0; i < table.size(); i++) {
+        file.write(padding, table[i].offset - written);
+        file.write(reinterpret_cast<const char*>(payloads[i].data()), payloads[i].size());
+        written = table[i].offset + table[i].size;
+    }
+    if (!file)
+        throw std::runtime_error("Could not write cooked texture: " + out_path);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "glad/gl.h"
+
+using std::string;
+using std::vector;
+
+enum class CookedFormat : uint32_t {
+    RGBA8 = 0,
+    // opaque color, 4 bits per pixel.
+    BC1 = 1,
+    // color with alpha, 8 bits per pixel.
+    BC3 = 2,
+    // two channel data such as normal maps (red and green), 8 bits per pixel.
+    BC5 = 3
+};
+
+struct cooked_level {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// A texture cooked offline into a ".lxt" container: a small header, a table of mip levels and then every level's
+// payload at a 16 byte aligned offset, already in the layout the gpu expects.  The file is memory mapped and each
+// level is handed to gl as is, so loading does no decoding and no glGenerateMipmap.
+//
+// Layout (little endian):
+//   char magic[4] "LXTC", u32 version, u32 format, u32 width, u32 height, u32 level_count, u32 reserved[2]
+//   level_count * { u64 offset, u64 size, u32 width, u32 height }
+//   level payloads
+
+class cooked_texture {
+public:
+    // Maps the file.  Throws std::runtime_error if it can't be opened or is malformed.
+    cooked_texture(const string& file_path);
+    // Builds an uncompressed RGBA8 mip chain in memory from decoded pixels with 3 or 4 channels.
+    cooked_texture(const unsigned char* pixels, int width, int height, int channels);
+    ~cooked_texture();
+
+    cooked_texture(const cooked_texture&) = delete;
+    cooked_texture& operator=(const cooked_texture&) = delete;
+
+    // Uploads mip levels first_level and below to target (GL_TEXTURE_2D or a cube map face) of the currently bound
+    // texture.  first_level becomes gl level 0.
+    void upload_levels(GLenum target, size_t first_level = 0) const;
+    // bytes taken by first_level and every smaller level.
+    size_t byte_size(size_t first_level) const;
+    const unsigned char* level_data(size_t level) const;
+    size_t byte_size() const;
+    bool is_compressed() const;
+    GLenum gl_internal_format() const;
+
+    // Whether the current gl context can sample the format.  BC1 and BC3 need EXT_texture_compression_s3tc.
+    static bool format_supported(CookedFormat format);
+    // "textures/wood.png" -> "textures/wood.lxt"
+    static string cooked_path(const string& source_path);
+    // Returns the cooked file to load instead of source_path, or an empty string when the source should be decoded.
+    // A cooked file is used when it is at least as new as its source and the context supports its format.
+    static string find_cooked(const string& source_path);
+    // Decodes source_path, builds its mip chain, encodes it as format and writes the container to out_path.
+    // Needs no gl context.  Throws std::runtime_error on failure.
+    static void cook(const string& source_path, const string& out_path, CookedFormat format, bool generate_mips = true);
+
+    string file_path;
+    CookedFormat format = CookedFormat::RGBA8;
+    uint32_t width = 0, height = 0;
+    vector<cooked_level> levels;
+
+    // while false cooked textures are ignored and every texture is decoded from its source image.
+    static bool prefer_cooked;
+    static inline void set_prefer_cooked(bool value) { prefer_cooked = value; }
+    static inline bool is_prefer_cooked() { return prefer_cooked; }
+private:
+    void unmap();
+
+    const unsigned char* data = nullptr;
+    size_t data_size = 0;
+    // backing storage for chains built in memory, empty for mapped files.
+    vector<unsigned char> owned;
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#endif
+};
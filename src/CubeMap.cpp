@@ -1,33 +1,69 @@
 #include "CubeMap.h"
 #include <stdexcept>
+#include <iostream>
+#include <vector>
+#include <memory>
+#include "CookedTexture.h"
 
 #include <stb_image.h>
 
-#define load_cubemap_img(path, glside) unsigned char* path##_img_data = stbi_load(path##_path.c_str(), &width, &height, &nrChannels, 0);\
-    if (path##_img_data) {\
-        glTexImage2D(\
-            glside, \
-            0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, path##_img_data\
-        );\
-        stbi_image_free(path##_img_data);\
-    } else {\
-        throw std::runtime_error("Failed to load cubemap texture at: " + path##_path);\
+// faces of a cube map must share one internal format and be square, so cooked files are only used when all six
+// have one with matching formats and sizes.  Returns the opened cooked faces or an empty vector.
+static vector<std::unique_ptr<cooked_texture>> open_cooked_faces(const string* paths) {
+    vector<std::unique_ptr<cooked_texture>> ret;
+    for (int i = 0; i < 6; i++) {
+        string cooked_file = cooked_texture::find_cooked(paths[i]);
+        if (cooked_file.empty())
+            return {};
+        try {
+            ret.push_back(std::make_unique<cooked_texture>(cooked_file));
+        } catch (std::runtime_error& e) {
+            std::cerr << e.what() << "\n";
+            return {};
+        }
+        const cooked_texture& face = *ret.back();
+        if (face.width != face.height || face.format != ret[0]->format || face.width != ret[0]->width || face.height != ret[0]->height || face.levels.size() != ret[0]->levels.size())
+            return {};
     }
-
+    return ret;
+}
 
 void cubemap::load_textures(string right_path, string left_path, string top_path, string bottom_path, string back_path, string front_path) {
     glGenTextures(1, &this->texture);
     glBindTexture(GL_TEXTURE_CUBE_MAP, this->texture);
-    int width, height, nrChannels;
-    
-    load_cubemap_img(right, GL_TEXTURE_CUBE_MAP_POSITIVE_X);
-    load_cubemap_img(left, GL_TEXTURE_CUBE_MAP_NEGATIVE_X);
-    load_cubemap_img(top, GL_TEXTURE_CUBE_MAP_POSITIVE_Y);
-    load_cubemap_img(bottom, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y);
-    load_cubemap_img(front, GL_TEXTURE_CUBE_MAP_POSITIVE_Z);
-    load_cubemap_img(back, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z);
 
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    const string paths[6] = {right_path, left_path, top_path, bottom_path, front_path, back_path};
+    const GLenum sides[6] = {
+        GL_TEXTURE_CUBE_MAP_POSITIVE_X,
+        GL_TEXTURE_CUBE_MAP_NEGATIVE_X,
+        GL_TEXTURE_CUBE_MAP_POSITIVE_Y,
+        GL_TEXTURE_CUBE_MAP_NEGATIVE_Y,
+        GL_TEXTURE_CUBE_MAP_POSITIVE_Z,
+        GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
+    };
+
+    GLint levels = 1;
+    auto cooked_faces = open_cooked_faces(paths);
+    if (!cooked_faces.empty()) {
+        for (int i = 0; i < 6; i++)
+            cooked_faces[i]->upload_levels(sides[i]);
+        levels = static_cast<GLint>(cooked_faces[0]->levels.size());
+    } else {
+        int width, height, nrChannels;
+        for (int i = 0; i < 6; i++) {
+            unsigned char* img_data = stbi_load(paths[i].c_str(), &width, &height, &nrChannels, 0);
+            if (!img_data)
+                throw std::runtime_error("Failed to load cubemap texture at: " + paths[i]);
+            glTexImage2D(
+                sides[i],
+                0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, img_data
+            );
+            stbi_image_free(img_data);
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -1,2 +1,289 @@
 #include "Emitter.h"
- 
\ No newline at end of file
+#include "TextureStreamer.h"
+#include <cmath>
+#include <cstring>
+#include <chrono>
+
+uint64_t emitter::next_seed = 1;
+GLuint emitter::quad_VBO = 0;
+
+void emitter::set_seed(uint64_t seed) {
+    rng.set_seed(seed);
+    spawn_particles(0, particles.size());
+}
+
+emitter::spawn_basis emitter::make_spawn_basis() {
+    quaternion dir = *direction;
+    return {position->axis, dir.get_forward().axis, dir.get_up().axis, dir.get_right().axis};
+}
+
+void emitter::resize_particles() {
+    // particles past active are stale, they get respawned with the new ones.
+    size_t old_count = std::min(particles.size(), active);
+    size_t count = static_cast<size_t>(std::max(rate, 0));
+    particles.resize(count);
+    instance_data.resize(count * PARTICLE_INSTANCE_FLOATS);
+    active = count;
+    // every particle can die in the same frame, after this the update never allocates.
+    chunk_dead.resize(chunk_count());
+    chunk_bounds.resize(chunk_count());
+    chunk_collisions.resize(chunk_count());
+    chunk_collision_ms.resize(chunk_count());
+    for (auto& dead : chunk_dead)
+        dead.reserve(PARTICLE_CHUNK);
+    spawn_random.reserve(std::min<size_t>(count, PARTICLE_CHUNK) * SPAWN_RANDOMS);
+    if (count > old_count)
+        spawn_particles(old_count, count - old_count);
+}
+
+void emitter::spawn_particles(size_t first, size_t count, const uint32_t* indices) {
+    if (count == 0)
+        return;
+    spawn_random.resize(count * SPAWN_RANDOMS);
+    rng.fill(spawn_random.data(), spawn_random.size());
+    spawn_basis basis = make_spawn_basis();
+    for (size_t n = 0; n < count; n++)
+        spawn_particle(indices ? indices[n] : first + n, basis, &spawn_random[n * SPAWN_RANDOMS]);
+}
+
+static inline float in_range(float r, float low, float high) {
+    return low + r * (high - low);
+}
+
+void emitter::spawn_particle(size_t i, const spawn_basis& basis, const float* r) {
+    // Rolls the emitter's basis around forward by a random angle, then tilts forward towards the rolled right and up
+    // by up to spread.  The same cone the quaternion rotations used to give, without building three quaternions.
+    float roll = r[0] * PI * 2;
+    float yaw = in_range(r[1], -spread, spread);
+    float pitch = in_range(r[2], -spread, spread);
+    float vel = in_range(r[3], start_velocity_min, start_velocity_max);
+
+    glm::vec3 right = std::cos(roll) * basis.right + std::sin(roll) * basis.up;
+    glm::vec3 up = std::cos(roll) * basis.up - std::sin(roll) * basis.right;
+    glm::vec3 velocity = (std::cos(pitch) * (std::cos(yaw) * basis.forward + std::sin(yaw) * right) + std::sin(pitch) * up) * vel;
+    float life = in_range(r[4], start_lifetime_min, start_lifetime_max);
+
+    particles.position_x[i] = basis.origin.x;
+    particles.position_y[i] = basis.origin.y;
+    particles.position_z[i] = basis.origin.z;
+    particles.velocity_x[i] = velocity.x;
+    particles.velocity_y[i] = velocity.y;
+    particles.velocity_z[i] = velocity.z;
+    particles.life[i] = life;
+
+    float* out = &instance_data[i * PARTICLE_INSTANCE_FLOATS];
+    out[PARTICLE_POSITION_OFFSET] = basis.origin.x;
+    out[PARTICLE_POSITION_OFFSET + 1] = basis.origin.y;
+    out[PARTICLE_POSITION_OFFSET + 2] = basis.origin.z;
+    for (int c = 0; c < 4; c++)
+        out[PARTICLE_COLOR_OFFSET + c] = in_range(r[5 + c], color_min->axis[c], color_max->axis[c]);
+    out[PARTICLE_SCALE_OFFSET] = in_range(r[9], scale_min->axis.x, scale_max->axis.x);
+    out[PARTICLE_SCALE_OFFSET + 1] = in_range(r[10], scale_min->axis.y, scale_max->axis.y);
+    out[PARTICLE_LIFE_OFFSET] = life;
+    out[PARTICLE_STARTING_LIFE_OFFSET] = life;
+}
+
+void emitter::prepare_simulation() {
+    if (particles.size() != static_cast<size_t>(std::max(rate, 0)))
+        resize_particles();
+    sorted = false;
+}
+
+void emitter::set_active(size_t count) {
+    count = std::min(count, particles.size());
+    if (count > active)
+        spawn_particles(active, count - active);
+    active = count;
+}
+
+void emitter::simulate_chunk(size_t chunk, float dt) {
+    size_t begin = chunk * PARTICLE_CHUNK;
+    size_t end = std::min(active, begin + PARTICLE_CHUNK);
+    vector<uint32_t>& dead = chunk_dead[chunk];
+    dead.clear();
+    chunk_collisions[chunk] = 0;
+    chunk_collision_ms[chunk] = 0.0;
+    if (collides()) {
+        // collision runs inside the integration, so the time covers the whole colliding update.
+        particle_collision collision{&collision_shapes, collision_response, restitution};
+        auto start = std::chrono::steady_clock::now();
+        chunk_collisions[chunk] = integrate_particles(particles, begin, end, dt, decay_rate, velocity_decay, instance_data.data(), dead, collision);
+        chunk_collision_ms[chunk] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    } else {
+        integrate_particles(particles, begin, end, dt, decay_rate, velocity_decay, instance_data.data(), dead);
+    }
+
+    // dead particles are counted too, they respawn at the origin which finish_simulation adds anyway.
+    glm::vec3 low(particles.position_x[begin], particles.position_y[begin], particles.position_z[begin]);
+    glm::vec3 high = low;
+    for (size_t i = begin + 1; i < end; i++) {
+        low.x = std::min(low.x, particles.position_x[i]);
+        low.y = std::min(low.y, particles.position_y[i]);
+        low.z = std::min(low.z, particles.position_z[i]);
+        high.x = std::max(high.x, particles.position_x[i]);
+        high.y = std::max(high.y, particles.position_y[i]);
+        high.z = std::max(high.z, particles.position_z[i]);
+    }
+    chunk_bounds[chunk] = {low, high};
+}
+
+void emitter::finish_simulation() {
+    for (auto& dead : chunk_dead) {
+        spawn_particles(0, dead.size(), dead.data());
+        dead.clear();
+    }
+    bounds_min = bounds_max = position->axis;
+    for (size_t c = 0; c < chunk_count(); c++) {
+        bounds_min = glm::min(bounds_min, chunk_bounds[c].first);
+        bounds_max = glm::max(bounds_max, chunk_bounds[c].second);
+    }
+    bounds_ready = true;
+
+    collisions = 0;
+    collision_ms = 0.0;
+    for (size_t c = 0; c < chunk_count(); c++) {
+        collisions += chunk_collisions[c];
+        collision_ms += chunk_collision_ms[c];
+    }
+}
+
+void emitter::add_collision_plane(const vec3& point, const vec3& normal) {
+    glm::vec3 n = glm::normalize(normal.axis);
+    collision_shapes.planes.push_back({{n.x, n.y, n.z}, -glm::dot(n, point.axis)});
+}
+
+void emitter::add_collision_sphere(const vec3& center, float radius) {
+    collision_shapes.spheres.push_back({{center.axis.x, center.axis.y, center.axis.z}, radius});
+}
+
+void emitter::clear_collision_shapes() {
+    collision_shapes.planes.clear();
+    collision_shapes.spheres.clear();
+}
+
+void emitter::gather_colliders(particle_collider_grid* grid) {
+    collision_shapes.boxes.clear();
+    if (!grid)
+        return;
+    // last frame's bounds, grown by how far the fastest particle can get this frame.
+    glm::vec3 origin = position->axis;
+    glm::vec3 low = bounds_ready ? glm::min(bounds_min, origin) : origin;
+    glm::vec3 high = bounds_ready ? glm::max(bounds_max, origin) : origin;
+    float reach = std::max(std::abs(start_velocity_min), std::abs(start_velocity_max)) * step_dt;
+    grid->query(low - reach, high + reach, collision_shapes.boxes);
+}
+
+void emitter::sort_particles(const glm::mat4& view) {
+    auto start = std::chrono::steady_clock::now();
+    size_t count = active;
+    depth.resize(count);
+    // distance in front of the camera, the view space z row negated since the camera looks down -z.
+    glm::vec4 row(view[0][2], view[1][2], view[2][2], view[3][2]);
+    for (size_t i = 0; i < count; i++)
+        depth[i] = -(row.x * particles.position_x[i] + row.y * particles.position_y[i] + row.z * particles.position_z[i] + row.w);
+    last_sort = sorter.sort(depth.data(), count);
+    sorted = true;
+    sort_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void emitter::write_chunk(size_t chunk, float* instances) const {
+    size_t begin = chunk * PARTICLE_CHUNK;
+    size_t end = std::min(active, begin + PARTICLE_CHUNK);
+    if (!sorted) {
+        std::memcpy(instances + begin * PARTICLE_INSTANCE_FLOATS, instance_data.data() + begin * PARTICLE_INSTANCE_FLOATS,
+            (end - begin) * PARTICLE_INSTANCE_FLOATS * sizeof(float));
+        return;
+    }
+    for (size_t i = begin; i < end; i++)
+        std::memcpy(instances + i * PARTICLE_INSTANCE_FLOATS, instance_data.data() + sorter.order[i] * PARTICLE_INSTANCE_FLOATS,
+            PARTICLE_INSTANCE_FLOATS * sizeof(float));
+}
+
+void emitter::render(const camera & cam) {
+    size_t count = instances.size / (PARTICLE_INSTANCE_FLOATS * sizeof(float));
+    if (!emitting || count == 0)
+        return;
+    const size_t stride = PARTICLE_INSTANCE_FLOATS * sizeof(float);
+
+    material->data->use_material();
+    material->data->set_uniform("projection", cam.projection);
+    material->data->set_uniform("view", cam.view);
+    material->data->set_uniform("sprite", 0);
+    material->data->register_uniforms();
+    glActiveTexture(GL_TEX_N_ITTER[0]);
+    material->data->diffuse_texture->data->bind();
+    texture_streamer::request_full(material->data->diffuse_texture->data);
+
+    if (draws_instanced()) {
+        if (!gl_quad_VAO)
+            create_quad_VAO();
+        glBindVertexArray(gl_quad_VAO);
+        // there's no base instance before gl 4.2, so the range's offset goes in the attribute pointers instead of
+        // the draw, and they're set again whenever it moves.
+        if (instances.generation != quad_attribute_generation || instances.offset != quad_attribute_offset) {
+            quad_attribute_generation = instances.generation;
+            quad_attribute_offset = instances.offset;
+            set_instance_attributes(instances.buffer, instances.offset);
+        }
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+    } else {
+        glBindVertexArray(gl_VAO);
+        if (instances.generation != attribute_generation) {
+            attribute_generation = instances.generation;
+            set_instance_attributes(instances.buffer, 0);
+        }
+        glDrawArrays(GL_POINTS, static_cast<GLint>(instances.offset / stride), static_cast<GLsizei>(count));
+    }
+    glBindVertexArray(0);
+    instances = stream_range();
+}
+
+void emitter::create_VAO() {
+    // the attributes point into the streaming buffer, they are set by set_instance_attributes when drawing.
+    glGenVertexArrays(1, &gl_VAO);
+    glBindVertexArray(gl_VAO);
+    for (GLuint attribute = 0; attribute < 5; attribute++)
+        glEnableVertexAttribArray(attribute);
+    glBindVertexArray(0);
+}
+
+void emitter::create_quad_VAO() {
+    if (!quad_VBO) {
+        // a triangle strip, in the order the geometry shader emits its corners.
+        const float corners[8] = {-1.0f, 1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, -1.0f};
+        glGenBuffers(1, &quad_VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, quad_VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    }
+    glGenVertexArrays(1, &gl_quad_VAO);
+    glBindVertexArray(gl_quad_VAO);
+    for (GLuint attribute = 0; attribute < 5; attribute++) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    // corner
+    glBindBuffer(GL_ARRAY_BUFFER, quad_VBO);
+    glEnableVertexAttribArray(5);
+    glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindVertexArray(0);
+}
+
+void emitter::set_instance_attributes(GLuint buffer, size_t base) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    const GLsizei stride = PARTICLE_INSTANCE_FLOATS * sizeof(float);
+
+    // position
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)(base + PARTICLE_POSITION_OFFSET * sizeof(float)));
+
+    // Color
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + PARTICLE_COLOR_OFFSET * sizeof(float)));
+
+    // Scale
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(base + PARTICLE_SCALE_OFFSET * sizeof(float)));
+
+    // life
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)(base + PARTICLE_LIFE_OFFSET * sizeof(float)));
+
+    // starting life
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)(base + PARTICLE_STARTING_LIFE_OFFSET * sizeof(float)));
+}
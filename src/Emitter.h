@@ -5,28 +5,22 @@
 #include "Quaternion.h"
 #include "Material.h"
 #include <vector>
+#include <algorithm>
+#include <utility>
 #include "util.h"
 #include "Camera.h"
 #include <string>
 #include "glad/gl.h"
+#include "ParticleSimulation.h"
+#include "Random.h"
+#include "StreamBuffer.h"
+#include "ParticleCollision.h"
 
 using std::vector;
 
 // TODO: add deltatime for decay_rate
 const unsigned int indicie[1] = {0};
 
-class particle {
-public:
-    particle(){}
-    particle(vec3 position, vec2 scale, vec3 velocity, vec4 color, float life) : position(position), velocity(velocity), scale(scale), color(color), life(life), starting_life(life) {}
-
-    vec3 position, velocity; // position is relative to the emitter
-    vec2 scale;
-    vec4 color;
-    float life;
-    float starting_life;
-};
-
 class emitter {
     /// Uses a set of attributes to determine how the particles are emitted.
 public:
@@ -46,9 +40,10 @@ public:
         start_lifetime_max(start_lifetime_max),
         color_min(color_min),
         color_max(color_max),
-        material(material)
+        material(material),
+        rng(next_seed++)
     {
-        create_particles();
+        resize_particles();
         this->create_VAO();
     }
 
@@ -59,22 +54,51 @@ public:
     inline void stop() {
         emitting = false;
     }
+
+    // the seed of the emitter's random numbers.  Emitters are seeded in creation order, so a scene that creates
+    // them in the same order replays the same effects.
+    inline uint64_t get_seed() const {
+        return rng.get_seed();
+    }
+
+    // reseeds the emitter and respawns all of its particles, restarting the effect.
+    void set_seed(uint64_t seed);
     
-    inline void render(const camera & cam) {
-        while(particles.size() != rate) {
-            if (particles.size() < rate) {
-                particles.push_back(create_particle());
-            } else {
-                particles.pop_back();
-            }
-        }
-        if (emitting) {
-            material->data->use_material();
-            update_instance_batch(cam);
-        }
+    // The simulation is split so the window can spread it over the thread pool, none of these steps touch gl.
+    // prepare_simulation, then simulate_chunk for every chunk (in parallel), then finish_simulation.
+
+    // resizes the particles to rate.  Call before chunk_count.
+    void prepare_simulation();
+    // chunks of the active particles.
+    inline size_t chunk_count() const {
+        return (active + PARTICLE_CHUNK - 1) / PARTICLE_CHUNK;
+    }
+    // advances the particles of one chunk by dt and measures their bounds.  Different chunks may run at the same time.
+    void simulate_chunk(size_t chunk, float dt);
+    // respawns the particles that died in simulate_chunk, in the same order a single thread would.
+    // Draws from the emitter's random stream, so only one thread per emitter.
+    void finish_simulation();
+    // orders the particles back to front for a camera's view matrix, after finish_simulation.
+    void sort_particles(const glm::mat4& view);
+    // copies one chunk of instance data to instances, the emitter's whole instance array, in draw order.
+    void write_chunk(size_t chunk, float* instances) const;
+
+    // draws the particles from instances.  Only draws when the window has streamed this frame's instances.
+    void render(const camera & cam);
+
+    // Materials with a geometry shader get one point per particle and expand it to a quad themselves.  Materials
+    // without one draw a shared quad once per particle instead, and billboard it in the vertex shader
+    // (default_vertex_particle_instanced.glsl), which skips the geometry stage that is slow on many drivers.
+    inline bool draws_instanced() const {
+        return !material->data->geometry;
     }
 
-    vector<particle> particles;
+    // where this frame's instance data was streamed to, set by the window after the simulation.
+    stream_range instances;
+
+    particle_buffer particles;
+    // PARTICLE_INSTANCE_FLOATS per particle, kept between frames and copied to the streaming buffer as is.
+    vector<float> instance_data;
 
     vec3* position;
     quaternion* direction;
@@ -87,156 +111,92 @@ public:
     vec4* color_max;
     rc_material material;
     bool emitting = false;
-private:
-
-    inline void create_particles() {
-        for (size_t i = 0; i < rate; i++)
-        {
-            particles.push_back(create_particle());
-        }
+    // draw the particles back to front so alpha blending composites them correctly.
+    bool depth_sort = false;
+
+    // what particles do when they hit collision_shapes or, with collide_colliders, the box colliders of the
+    // window's objects.  Nothing is tested with NONE.
+    CollisionResponse collision_response = CollisionResponse::NONE;
+    // share of the velocity into the shape that BOUNCE keeps.
+    float restitution = 0.5f;
+    bool collide_colliders = false;
+    // world space planes and spheres, the boxes are refilled by gather_colliders every frame.
+    particle_obstacles collision_shapes;
+    // the plane through point, particles behind normal are inside.
+    void add_collision_plane(const vec3& point, const vec3& normal);
+    void add_collision_sphere(const vec3& center, float radius);
+    void clear_collision_shapes();
+    inline bool collides() const {
+        return collision_response != CollisionResponse::NONE && (collide_colliders || !collision_shapes.empty());
     }
-
-    inline particle create_particle() {
-        
-        quaternion dir = *direction;
-
-        float random_angle = rand_range(0.0f, 1.0f) * PI * 2;
-        float vel = rand_range(start_velocity_min, start_velocity_max);
-
-        dir.rotate(dir.get_forward(), random_angle);
-        dir.rotate(dir.get_up(), rand_range(-spread, spread));
-        dir.rotate(dir.get_right(), rand_range(-spread, spread));
-        
-        vec4 color(rand_range(color_min->axis.x, color_max->axis.x), rand_range(color_min->axis.y, color_max->axis.y), rand_range(color_min->axis.z, color_max->axis.z), rand_range(color_min->axis.w, color_max->axis.w));
-        
-        vec2 scale(rand_range(scale_min->axis.x, scale_max->axis.x), rand_range(scale_min->axis.y, scale_max->axis.y));
-
-        return particle(
-            *position,
-            scale,
-            dir.get_forward() * vel,
-            color,
-            rand_range(start_lifetime_min, start_lifetime_max)
-        );
-    }
-
-    inline void update_particle(particle *p, const camera * cam = nullptr) {
-        p->life -= cam ? decay_rate * (float)*cam->deltatime : decay_rate;
-        if (p->life <= 0.0f) {
-            auto new_p = create_particle();
-            p->color = new_p.color;
-            p->position = new_p.position;
-            p->velocity = new_p.velocity;
-            p->life = new_p.life;
-            p->starting_life = new_p.starting_life;
-            p->scale = new_p.scale;
-            return;
-        }
-        p->position += cam ? p->velocity * (float)*cam->deltatime : p->velocity;
-        p->velocity -= cam ? velocity_decay * (float)*cam->deltatime : velocity_decay;
-    }
-
-    inline void update_instance_batch(const camera & cam) {
-        
-        vector<float> instance_vbo_update;
-        unsigned int i = 0;
-        for (particle & p : particles) {
-            update_particle(&p, &cam);
-            instance_vbo_update.push_back(p.position.axis.x);
-            instance_vbo_update.push_back(p.position.axis.y);
-            instance_vbo_update.push_back(p.position.axis.z);
-
-            instance_vbo_update.push_back(p.color.axis.x);
-            instance_vbo_update.push_back(p.color.axis.y);
-            instance_vbo_update.push_back(p.color.axis.z);
-            instance_vbo_update.push_back(p.color.axis.w);
-
-            instance_vbo_update.push_back(p.scale.axis.x);
-            instance_vbo_update.push_back(p.scale.axis.y);
-
-            instance_vbo_update.push_back(p.life);
-
-            instance_vbo_update.push_back(p.starting_life);
-            
-            i++;
-        }
-        glBindBuffer(GL_ARRAY_BUFFER, gl_VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, instance_vbo_update.size() * sizeof(float), instance_vbo_update.data());
-
-        material->data->set_uniform("projection", cam.projection);
-        material->data->set_uniform("view", cam.view);
-        material->data->set_uniform("sprite", 0);
-        material->data->register_uniforms();
-        glActiveTexture(GL_TEX_N_ITTER[0]);
-        material->data->diffuse_texture->data->bind();
-
-        glBindVertexArray(gl_VAO);
-        glDrawArrays(GL_POINTS, 0, rate);
-        glBindVertexArray(0);
-    }
-
-    inline void create_VAO() {
-
-        vector<float> instance_vbo_update;
-        unsigned int i = 0;
-        for (particle & p : particles) {
-            update_particle(&p);
-            instance_vbo_update.push_back(p.position.axis.x);
-            instance_vbo_update.push_back(p.position.axis.y);
-            instance_vbo_update.push_back(p.position.axis.z);
-
-            instance_vbo_update.push_back(p.color.axis.x);
-            instance_vbo_update.push_back(p.color.axis.y);
-            instance_vbo_update.push_back(p.color.axis.z);
-            instance_vbo_update.push_back(p.color.axis.w);
-
-            instance_vbo_update.push_back(p.scale.axis.x);
-            instance_vbo_update.push_back(p.scale.axis.y);
-
-            instance_vbo_update.push_back(p.life);
-
-            instance_vbo_update.push_back(p.starting_life);
-            
-            i++;
-        }
-        
-        // Create VAO
-        glGenVertexArrays(1, &gl_VAO);
-        glBindVertexArray(gl_VAO);
-
-        // Create VBO
-        glGenBuffers(1, &gl_VBO);
-        glBindBuffer(GL_ARRAY_BUFFER, gl_VBO);
-        glBufferData(GL_ARRAY_BUFFER, instance_vbo_update.size() * sizeof(float), instance_vbo_update.data(), GL_DYNAMIC_DRAW);
-
-        // Create EBO
-        // glGenBuffers(1, &gl_EBO);
-        // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gl_EBO);
-        // glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int), indicie, GL_STATIC_DRAW);
-
-        // position
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(0 * sizeof(float)));
-        glEnableVertexAttribArray(0);
-        
-
-        // Color
-        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
-
-        // Scale
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(7 * sizeof(float)));
-        glEnableVertexAttribArray(2);
-
-        // life
-        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(9 * sizeof(float)));
-        glEnableVertexAttribArray(3);
-
-        // starting life
-        glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, 11 * sizeof(float), (void*)(10 * sizeof(float)));
-        glEnableVertexAttribArray(4);
-
-        glBindVertexArray(0);
-    }
-
-    GLuint gl_VAO, gl_VBO, gl_EBO;
+    // replaces collision_shapes.boxes with grid's boxes near the particles, or none without a grid.  After
+    // particle_lod::apply, before simulate_chunk.
+    void gather_colliders(particle_collider_grid* grid);
+    // particles that hit something in the last simulation and the time the colliding update took, summed over the chunks.
+    size_t collisions = 0;
+    double collision_ms = 0.0;
+
+    // level of detail, set by particle_lod::apply before the simulation.
+    // particles that are simulated and drawn, the first active of particles.  The rest wait untill the lod
+    // brings them back, see set_active.
+    size_t active = 0;
+    // whether the particles are drawn this frame.
+    bool visible = true;
+    // whether the particles are simulated this frame and by how long.  Offscreen emitters add up the time they skip.
+    bool step = true;
+    float step_dt = 0.0f;
+    float pending_dt = 0.0f;
+    int pending_frames = 0;
+    // changes the number of active particles, respawning the ones that come back.
+    void set_active(size_t count);
+
+    // world space bounds of the active particles after the last simulation, including the origin.
+    glm::vec3 bounds_min = glm::vec3(0.0f), bounds_max = glm::vec3(0.0f);
+    bool bounds_ready = false;
+
+    // whether this frame's particles were sorted, how and how long it took in milliseconds.
+    bool sorted = false;
+    particle_sorter::sort_method last_sort = particle_sorter::REUSED;
+    double sort_ms = 0.0;
+private:
+    // random numbers used to spawn one particle: roll, yaw, pitch, speed, life, color rgba and scale xy.
+    static constexpr size_t SPAWN_RANDOMS = 11;
+    static uint64_t next_seed;
+
+    // the emitter's direction as a basis, worked out once per frame instead of per particle.
+    struct spawn_basis {
+        glm::vec3 origin, forward, up, right;
+    };
+
+    spawn_basis make_spawn_basis();
+    // grows or shrinks the particles to rate, spawning the new ones.
+    void resize_particles();
+    // spawns count particles, at indices[n] or, without indices, at first + n.
+    // Draws the random numbers for all of them in one batch.
+    void spawn_particles(size_t first, size_t count, const uint32_t* indices = nullptr);
+    // writes a fresh particle at index i, in the simulation state and the instance data.  r holds SPAWN_RANDOMS
+    // numbers in [0, 1).
+    void spawn_particle(size_t i, const spawn_basis& basis, const float* r);
+    void create_VAO();
+    // the instanced path's VAO: the shared quad at attribute 5 and the per particle attributes advancing once
+    // per instance.  Made on the first instanced draw.
+    void create_quad_VAO();
+    // points the bound VAO's attributes at the streaming buffer the instance data was written to, base bytes in.
+    void set_instance_attributes(GLuint buffer, size_t base);
+
+    random_stream rng;
+    // particles that died in each chunk, reserved so the update never allocates.
+    vector<vector<uint32_t>> chunk_dead;
+    vector<std::pair<glm::vec3, glm::vec3>> chunk_bounds;
+    vector<size_t> chunk_collisions;
+    vector<double> chunk_collision_ms;
+    vector<float> spawn_random;
+    particle_sorter sorter;
+    vector<float> depth;
+    GLuint gl_VAO = 0;
+    size_t attribute_generation = 0;
+    GLuint gl_quad_VAO = 0;
+    size_t quad_attribute_generation = 0, quad_attribute_offset = 0;
+    // corners of the quad every instanced emitter draws, shared by all of them.
+    static GLuint quad_VBO;
 };
\ No newline at end of file
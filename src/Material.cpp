@@ -3,6 +3,8 @@
 #include <sstream>
 #include "Texture.h"
 #include "Object3d.h"
+#include "ResourceCache.h"
+#include "ProgramCache.h"
 
 void material::set_uniform(string name, uniform_type value) {
     int loc = glGetUniformLocation(this->shader_program, name.c_str());
@@ -56,6 +58,19 @@ void TRAIT_has_uniform::register_uniforms() {
 } 
 
 void material::link_shaders() {
+    // materials built from the same shader sources share one program.
+    uint64_t program_key = resource_cache::program_key(this->vertex, this->fragment, this->geometry, this->compute);
+    if (GLuint cached_program = resource_cache::find_program(program_key)) {
+        this->shader_program = cached_program;
+        return;
+    }
+    // then programs linked by an earlier run of the engine.
+    if (GLuint disk_program = program_binary_cache::load(program_key)) {
+        this->shader_program = disk_program;
+        resource_cache::store_program(program_key, disk_program, false);
+        return;
+    }
+
     this->vertex->data->compile();
     this->fragment->data->compile();
     if (this->geometry)
@@ -69,6 +84,7 @@ void material::link_shaders() {
         glAttachShader(this->shader_program, this->geometry->data->shader_handle);
     if (this->compute)
         glAttachShader(this->shader_program, this->compute->data->shader_handle);
+    program_binary_cache::prepare_program(this->shader_program);
     
     glLinkProgram(this->shader_program);
     
@@ -91,6 +107,8 @@ void material::link_shaders() {
         glDeleteShader(this->geometry->data->shader_handle);
     if (this->compute)
         glDeleteShader(this->compute->data->shader_handle);
+    resource_cache::store_program(program_key, this->shader_program);
+    program_binary_cache::store(program_key, this->shader_program);
 }
 
 void material::set_material() {
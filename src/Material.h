@@ -52,10 +52,12 @@ typedef RC<shader*>* rc_shader;
 class material : public TRAIT_has_uniform {
 public:
     
-    material(rc_shader vertex, rc_shader fragment, rc_shader geometry = nullptr, rc_shader compute = nullptr)
+    // when defer_link is set link_shaders() must be called on the gl thread before the material is used.
+    material(rc_shader vertex, rc_shader fragment, rc_shader geometry = nullptr, rc_shader compute = nullptr, bool defer_link = false)
     : vertex(vertex), fragment(fragment), geometry(geometry), compute(compute)
     {
-        this->link_shaders();
+        if (!defer_link)
+            this->link_shaders();
     }
 
     ~material(){}
@@ -73,7 +75,7 @@ public:
     rc_shader fragment = nullptr;
     rc_shader geometry = nullptr;
     rc_shader compute = nullptr;
-    GLuint shader_program;
+    GLuint shader_program = 0;
     string name;
     vec3 ambient = vec3(0.1f, 0.1f, 0.1f);
     vec3 diffuse = vec3(1.0f, 1.0f, 1.0f);
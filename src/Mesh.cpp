@@ -9,24 +9,90 @@
 #include <sstream>
 #include "Model.h"
 #include "Animation.h"
+#include "ResourceCache.h"
+#include "Skinning.h"
+#include <chrono>
 
 
 string fix_texture_path(string file_path, string file) {
     return std::filesystem::absolute(std::filesystem::path(str_tool::rem_file_from_path(file_path) + "/textures/" + str_tool::rem_path_from_file(file))).string();
 }
 
-void mesh::process_node(rc_model model, aiNode* node, const aiScene* scene, rc_mesh_dict last_mesh_dict, const aiMatrix4x4& transform, string file_path) {
-    
+// every texture file the scene's materials reference, resolved the same way the get_textures macro does.
+static vector<string> collect_texture_paths(const aiScene* scene, const string& file_path) {
+    vector<string> ret;
+    for (size_t m_n = 0; m_n < scene->mNumMaterials; m_n++) {
+        auto ai_mat = scene->mMaterials[m_n];
+        for (aiTextureType aitype : {aiTextureType_DIFFUSE, aiTextureType_SPECULAR, aiTextureType_NORMALS}) {
+            for (size_t t_n = 0; t_n < ai_mat->GetTextureCount(aitype); t_n++) {
+                aiString path;
+                if (ai_mat->GetTexture(aitype, t_n, &path) == AI_SUCCESS && str_tool::rem_path_from_file(string(path.C_Str())).find(".") != std::string::npos)
+                    ret.push_back(fix_texture_path(file_path, string(path.C_Str())));
+            }
+        }
+    }
+    ret.push_back(get_mod_path() + "/MissingTexture.jpg");
+    return ret;
+}
+
+// drops the material along with its references to shaders and textures.
+static void release_material(rc_material mat) {
+    for (rc_shader shdr : {mat->data->vertex, mat->data->fragment, mat->data->geometry, mat->data->compute}) {
+        if (shdr)
+            RC_collect(shdr);
+    }
+    for (rc_texture tex : {mat->data->diffuse_texture, mat->data->specular_texture, mat->data->normals_texture}) {
+        if (tex)
+            RC_collect(tex);
+    }
+    RC_collect(mat);
+}
+
+static void release_mesh_dict(rc_mesh_dict dict) {
+    for (auto& [name, child] : dict->data->data) {
+        if (std::holds_alternative<rc_mesh>(child)) {
+            auto msh = std::get<rc_mesh>(child);
+            if (msh->data->mesh_material)
+                release_material(msh->data->mesh_material);
+            RC_collect(msh);
+        } else {
+            auto child_dict = std::get<rc_mesh_dict>(child);
+            release_mesh_dict(child_dict);
+            RC_collect(child_dict);
+        }
+    }
+    dict->data->data.clear();
+}
+
+void mesh::release_import(rc_model model) {
+    release_mesh_dict(model->data->mesh_data);
+    for (auto& [name, anim] : model->data->animations)
+        delete anim;
+    model->data->animations.clear();
+}
+
+void mesh::process_node(rc_model model, aiNode* node, const aiScene* scene, rc_mesh_dict last_mesh_dict, const aiMatrix4x4& transform, string file_path, vector<std::function<void()>>* deferred_uploads) {
+    bool defer = deferred_uploads != nullptr;
     // itterate meshes for the node
     auto t_aivec3 = transform * aiVector3D(1.0f, 1.0f, 1.0f);
     for (size_t m_n = 0; m_n < node->mNumMeshes; m_n++) {
         auto msh = scene->mMeshes[node->mMeshes[m_n]];
         auto mesh_name = string(msh->mName.C_Str());
-        rc_material mesh_material = new RC(new material(new RC(shader::from_file(get_mod_path() + (model->data->animated ? "/default_vertex_animated.glsl" : "/default_vertex.glsl"), ShaderType::VERTEX)), new RC(shader::from_file(get_mod_path() + "/default_fragment.glsl", ShaderType::FRAGMENT))));
+        rc_material mesh_material = new RC(new material(
+            resource_cache::get_shader(get_mod_path() + (model->data->animated ? "/default_vertex_animated.glsl" : "/default_vertex.glsl"), ShaderType::VERTEX, defer),
+            resource_cache::get_shader(get_mod_path() + "/default_fragment.glsl", ShaderType::FRAGMENT, defer),
+            nullptr, nullptr, defer
+        ));
+        if (defer)
+            deferred_uploads->push_back([mesh_material]() { mesh_material->data->link_shaders(); });
         vector<tup<unsigned int, 3>>* faces = new vector<tup<unsigned int, 3>>();
         vector<vertex>* _vertexes = new vector<vertex>();
 
         vec3 _transform = vec3(t_aivec3.x, t_aivec3.y, t_aivec3.z);
+        // inserted before it is filled so that if anything below throws, release_import finds the mesh, its material
+        // and buffers.  Its gl buffers are made once the vertices are in.
+        auto ret_mesh = new RC(new mesh(mesh_name, mesh_material, _vertexes, faces, _transform, model->data->animated, true));
+        last_mesh_dict->data->insert(ret_mesh);
         vec3 aabb_max = vec3(0,0,0);
         vec3 aabb_min = vec3(0,0,0);
         
@@ -112,7 +178,10 @@ void mesh::process_node(rc_model model, aiNode* node, const aiScene* scene, rc_m
 
         if (mesh_material->data->diffuse_texture == nullptr) { // TODO add logic to allow for mesh color
             // insert default texture 
-            mesh_material->data->diffuse_texture = new RC(new texture(get_mod_path() + "/MissingTexture.jpg", TextureWraping::REPEAT, TextureFiltering::LINEAR));
+            auto missing_tex = resource_cache::get_texture(get_mod_path() + "/MissingTexture.jpg", TextureWraping::REPEAT, TextureFiltering::LINEAR, defer);
+            mesh_material->data->diffuse_texture = missing_tex;
+            if (defer)
+                deferred_uploads->push_back([missing_tex]() { missing_tex->data->upload(); });
         }
 
         
@@ -122,40 +191,35 @@ void mesh::process_node(rc_model model, aiNode* node, const aiScene* scene, rc_m
             v.weights = glm::normalize(v.weights);
         }
 
-        auto ret_mesh = new RC(new mesh(mesh_name, mesh_material, _vertexes, faces, _transform, model->data->animated));
+        if (defer)
+            deferred_uploads->push_back([ret_mesh]() { ret_mesh->data->upload(); });
+        else
+            ret_mesh->data->upload();
         ret_mesh->data->radius = radius;
         ret_mesh->data->aabb_max = aabb_max;
         ret_mesh->data->aabb_min = aabb_min;
-        last_mesh_dict->data->insert(ret_mesh);
     }
     
     // traverse to deeper nodes
     for (size_t c_n = 0; c_n < node->mNumChildren; c_n++) {
         auto child_mesh_dict = new RC(new mesh_dict());
         child_mesh_dict->data->name = node->mChildren[c_n]->mName.C_Str();
-        process_node(model, node->mChildren[c_n], scene, child_mesh_dict, transform * node->mChildren[c_n]->mTransformation, file_path);
+        // inserted first for the same reason as the meshes above.
+        last_mesh_dict->data->insert(child_mesh_dict);
+        process_node(model, node->mChildren[c_n], scene, child_mesh_dict, transform * node->mChildren[c_n]->mTransformation, file_path, deferred_uploads);
         
         if (child_mesh_dict->data->data.size() == 1 && // Check if it is duplicating the name with the dict
                     child_mesh_dict->data->data.contains(child_mesh_dict->data->name)) {
+            // takes the dict's place under the same name.
             last_mesh_dict->data->insert(child_mesh_dict->data->data[child_mesh_dict->data->name]);
             delete child_mesh_dict->data;
             delete child_mesh_dict;
-        }    
-        else
-            last_mesh_dict->data->insert(child_mesh_dict);
+        }
     }
 }
 
 
 rc_model mesh::from_file(string file_path, bool animated) {
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile( file_path, aiProcess_Triangulate | aiProcess_FlipUVs);
-
-    if (!scene) {
-        std::stringstream ss;
-        ss << "Failed to import model at \"" << file_path << "\"\nLOG:\n" << importer.GetErrorString() << "\n";
-        throw std::runtime_error(ss.str());
-    }
     auto curren_mesh_dict = new RC(new mesh_dict());
 
     curren_mesh_dict->data->name = file_path;
@@ -163,17 +227,85 @@ rc_model mesh::from_file(string file_path, bool animated) {
         curren_mesh_dict,
         animated
     ));
+
+    try {
+        import_into(ret, file_path);
+    } catch (...) {
+        release_import(ret);
+        RC_collect(ret->data->mesh_data);
+        RC_collect(ret);
+        throw;
+    }
     
-    ret->data->animated = scene->mNumAnimations > 0;
+    return ret;
+}
 
-    process_node(ret, scene->mRootNode, scene, curren_mesh_dict, scene->mRootNode->mTransformation, file_path);
+void mesh::import_into(rc_model model, string file_path, vector<std::function<void()>>* deferred_uploads) {
+    auto import_start = std::chrono::steady_clock::now();
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile( file_path, aiProcess_Triangulate | aiProcess_FlipUVs);
 
-    for (int i = 0; i < scene->mNumAnimations; i++)  {
-        ret->data->animations[scene->mAnimations[i]->mName.data] = new animation(scene, scene->mAnimations[i], ret);
-        ret->data->animated = true;
+    if (!scene) {
+        std::stringstream ss;
+        ss << "Failed to import model at \"" << file_path << "\"\nLOG:\n" << importer.GetErrorString() << "\n";
+        throw std::runtime_error(ss.str());
     }
     
-    return ret;
+    model->data->animated = scene->mNumAnimations > 0;
+
+    // decode every referenced image up front across the thread pool, the node walk below then only hits the cache.
+    vector<rc_texture> prefetched;
+    if (resource_cache::is_enabled()) {
+        prefetched = resource_cache::prefetch_textures(collect_texture_paths(scene, file_path), TextureWraping::REPEAT, TextureFiltering::LINEAR);
+        // one job per texture so the window's upload budget can stop between them.
+        for (auto tex : prefetched) {
+            auto upload_texture = [tex]() {
+                tex->data->upload();
+                RC_collect(tex);
+            };
+            if (deferred_uploads)
+                deferred_uploads->push_back(upload_texture);
+            else
+                upload_texture();
+        }
+    }
+
+    try {
+        process_node(model, scene->mRootNode, scene, model->data->mesh_data, scene->mRootNode->mTransformation, file_path, deferred_uploads);
+
+        for (int i = 0; i < scene->mNumAnimations; i++)  {
+            auto anim = new animation(scene, scene->mAnimations[i], model, deferred_uploads != nullptr);
+            model->data->animations[scene->mAnimations[i]->mName.data] = anim;
+            if (deferred_uploads)
+                deferred_uploads->push_back([anim]() { anim->dbg_vis_init(); });
+            model->data->animated = true;
+        }
+    } catch (...) {
+        if (deferred_uploads) {
+            // the queued jobs will never run, and the texture ones were going to release a reference each.
+            for (auto tex : prefetched)
+                RC_collect(tex);
+            deferred_uploads->clear();
+        }
+        throw;
+    }
+    resource_cache::set_last_import_ms(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - import_start).count());
+}
+
+mesh::~mesh() {
+    glDeleteVertexArrays(1, &gl_VAO);
+    glDeleteBuffers(1, &gl_VBO);
+    glDeleteBuffers(1, &gl_EBO);
+    delete faces;
+    delete vertices;
+    delete baked;
+}
+
+void mesh::upload() {
+    if (uploaded)
+        return;
+    this->create_VAO();
+    uploaded = true;
 }
  
 void mesh::create_VAO() {
@@ -20,6 +20,7 @@
 #include <variant>
 #include "Material.h"
 #include "util.h"
+#include <functional>
 
 #define MAX_BONE_INFLUENCE 4
 
@@ -29,6 +30,7 @@ using std::map;
 class mesh_dict;
 class mesh;
 class model;
+class vertex_animation_texture;
 
 typedef RC<mesh*>* rc_mesh;
 
@@ -75,7 +77,8 @@ public:
         vector<vertex>* vertices,
         vector<tup<unsigned int, 3>>* faces,
         vec3 transform,
-        bool is_animated = false
+        bool is_animated = false,
+        bool defer_upload = false
     ):
     name(name),
     mesh_material(mesh_material),
@@ -84,16 +87,22 @@ public:
     transform(transform),
     is_animated(is_animated)
     {
-        this->create_VAO();
-    }
-    ~mesh(){
-        glDeleteVertexArrays(1, &gl_VAO);
-        glDeleteBuffers(1, &gl_VBO);
-        glDeleteBuffers(1, &gl_EBO);
-        delete faces;
-        delete vertices;
+        if (!defer_upload)
+            this->upload();
     }
+    ~mesh();
     static rc_model from_file(string file_path, bool animated);
+    // Imports the asset into an already constructed model.  When deferred_uploads is not null no gl calls are made,
+    // instead the gl work is appended to deferred_uploads so the import can run off the gl thread.
+    // If it throws the references held by deferred_uploads' jobs are released and the vector is cleared, what was
+    // already built into the model is left for release_import().
+    static void import_into(rc_model model, string file_path, vector<std::function<void()>>* deferred_uploads = nullptr);
+    // Releases everything import_into built into model (meshes, their materials with the shaders and textures those
+    // hold, nested mesh_dicts and animations) and leaves it empty.  For imports that failed partway, gl thread only.
+    static void release_import(rc_model model);
+    // creates the gl buffers, must be called on the gl thread.
+    void upload();
+    bool uploaded = false;
     string name = "";
     rc_material mesh_material = nullptr;
 
@@ -106,13 +115,15 @@ public:
     float radius = 0.0f;
     void get_gl_vert_inds(vector<unsigned int>* mut_inds);
 
-    unsigned int gl_VAO, gl_VBO, gl_EBO;
+    unsigned int gl_VAO = 0, gl_VBO = 0, gl_EBO = 0;
     size_t indicies_size = 0;
     vec3 aabb_max = vec3(0.0f,0.0f,0.0f);
     vec3 aabb_min = vec3(0.0f,0.0f,0.0f);
+    // the model's baked animation for this mesh, see model::bake_animation.
+    vertex_animation_texture* baked = nullptr;
 private:
     // RETURNS A HEAP ALLOCATED POINTER
-    static void process_node(rc_model model, aiNode* node, const aiScene* scene, rc_mesh_dict last_mesh_dict, const aiMatrix4x4& transform, string file_path);
+    static void process_node(rc_model model, aiNode* node, const aiScene* scene, rc_mesh_dict last_mesh_dict, const aiMatrix4x4& transform, string file_path, vector<std::function<void()>>* deferred_uploads);
     void create_VAO();
 };
 
@@ -212,7 +223,10 @@ public:
             if (ai_mat->GetTexture(aitype, t_n, &path) == AI_SUCCESS) {\
                 if (str_tool::rem_path_from_file(string(path.C_Str())).find(".") != std::string::npos) {\
                     try {\
-                        mesh_material->data->type_name##_texture = new RC(new texture(fix_texture_path(file_path, string(path.C_Str())), TextureWraping::REPEAT, TextureFiltering::LINEAR));\
+                        auto type_name##_tex = resource_cache::get_texture(fix_texture_path(file_path, string(path.C_Str())), TextureWraping::REPEAT, TextureFiltering::LINEAR, deferred_uploads != nullptr);\
+                        mesh_material->data->type_name##_texture = type_name##_tex;\
+                        if (deferred_uploads)\
+                            deferred_uploads->push_back([type_name##_tex]() { type_name##_tex->data->upload(); });\
                     } catch ( std::runtime_error e ) {\
                         std::cerr << e.what();\
                     }\
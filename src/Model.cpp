@@ -1,19 +1,74 @@
 #include "Model.h"
 #include "Animation.h"
+#include "TextureStreamer.h"
+#include "Skinning.h"
+#include <limits>
+#include <functional>
 
 #define ATTENUATION_THRESHOLD 0.003
 
 void model::play_animation(const string& animation) {
-    animation_player->play(animations[animation]);
+    current_animation = find_animation(animation);
+    animation_generation++;
+}
+
+animation* model::find_animation(const string& animation) {
+    auto found = animations.find(animation);
+    if (found == animations.end())
+        throw std::runtime_error("No animation named \"" + animation + "\" in model.");
+    return found->second;
+}
+
+void model::calculate_bounds() {
+    aabb_max = vec3(-std::numeric_limits<float>::max());
+    aabb_min = vec3(std::numeric_limits<float>::max());
+    std::function<void(mesh_dict*)> grow = [&](mesh_dict* dict) {
+        for (auto [_name, child] : *dict) {
+            if (std::holds_alternative<rc_mesh>(child)) {
+                mesh* m = std::get<rc_mesh>(child)->data;
+                aabb_max.axis = glm::max(aabb_max.axis, m->aabb_max.axis);
+                aabb_min.axis = glm::min(aabb_min.axis, m->aabb_min.axis);
+            } else {
+                grow(std::get<rc_mesh_dict>(child)->data);
+            }
+        }
+    };
+    grow(mesh_data->data);
+    if (aabb_min.axis.x > aabb_max.axis.x)
+        aabb_min = aabb_max = vec3(0.0f);
+    bounds_ready = true;
+}
+
+void model::bake_animation(const string& animation, float fps) {
+    ::animation* clip = find_animation(animation);
+    std::function<void(mesh_dict*)> bake_dict = [&](mesh_dict* dict) {
+        for (auto [_name, child] : *dict) {
+            if (std::holds_alternative<rc_mesh>(child)) {
+                mesh* m = std::get<rc_mesh>(child)->data;
+                auto vat = new vertex_animation_texture(*m, clip, fps);
+                try {
+                    vat->upload();
+                } catch (...) {
+                    delete vat;
+                    throw;
+                }
+                delete m->baked;
+                m->baked = vat;
+            } else {
+                bake_dict(std::get<rc_mesh_dict>(child)->data);
+            }
+        }
+    };
+    bake_dict(mesh_data->data);
+    baked = true;
 }
 
 model::~model() {
-    delete animation_player;
     for (auto & [k, v] : animations)
         delete v;
 }
 
-model::model(RC<mesh_dict*>* mesh_data, bool animated) : mesh_data(mesh_data), animated(animated), animation_player(new animator(nullptr)) {}
+model::model(RC<mesh_dict*>* mesh_data, bool animated) : mesh_data(mesh_data), animated(animated) {}
 
 void model::render_meshdict(RC<mesh_dict*>* _mesh_data, object3d* obj, camera& camera, window* window) {
     for (auto [_mesh_name, _mesh_variant] : *_mesh_data->data) {
@@ -42,6 +97,20 @@ void model::render_meshdict(RC<mesh_dict*>* _mesh_data, object3d* obj, camera& c
                 use_default_material_properties
             );
 
+            if (texture_streamer::is_enabled()) {
+                // tell the streamer how large the textures we just bound are on screen.
+                float screen_px = texture_streamer::screen_size(camera, obj->model_matrix, _mesh->data->aabb_min, _mesh->data->aabb_max);
+                auto mesh_mat = _mesh->data->mesh_material->data;
+                auto obj_mat = obj->mat->data;
+                for (rc_texture tex : {
+                    obj_mat->diffuse_texture ? obj_mat->diffuse_texture : mesh_mat->diffuse_texture,
+                    obj_mat->specular_texture ? obj_mat->specular_texture : mesh_mat->specular_texture
+                }) {
+                    if (tex)
+                        texture_streamer::request(tex->data, screen_px);
+                }
+            }
+
             obj->mat->data->register_uniforms();
             obj->register_uniforms(); // register object level uniforms
 
@@ -85,9 +154,11 @@ void model::render_meshdict(RC<mesh_dict*>* _mesh_data, object3d* obj, camera& c
 
             obj->mat->data->set_uniform("total_spot_lights", static_cast<int>(i));
 
-            // update animations
-            if (obj->model_data->data->animated)
-                obj->model_data->data->animation_player->set_uniforms(obj->mat);
+            // bind the bone palette, uploaded once per frame.
+            if (_mesh->data->baked)
+                _mesh->data->baked->set_uniforms(obj->mat, obj->baked_time + obj->baked_time_offset);
+            else if (obj->model_data->data->animated && obj->animation_player)
+                obj->animation_player->set_uniforms(obj->mat);
             
             obj->mat->data->register_uniforms();
 
@@ -25,23 +25,44 @@ public:
     model(){}
     model(RC<mesh_dict*>* mesh_data, bool animated);
     inline void render(object3d* obj, camera& camera, window* window) {
+        if (!loaded)
+            return;
         render_meshdict(mesh_data, obj, camera, window);
     }
 
     ~model();
     RC<mesh_dict*>* mesh_data = nullptr;
     bool use_default_material_properties = false;
+    // false while an async load is still importing or uploading the model. (see AsyncLoader.h)
+    bool loaded = true;
     
     // ANIMATION STUFF
     bool animated = false;
     vector<bone_info> bone_info_list;
     int bone_counter = 0;
+    // clips shared by every object3d of this model, each object plays them with its own animator.
     std::map<string, animation*> animations;
-    animator* animation_player = nullptr;
+    // the clip objects play untill they pick their own with object3d::play_animation.
+    animation* current_animation = nullptr;
+    // bumped by play_animation so objects following the model restart the clip.
+    uint64_t animation_generation = 0;
     object3d * owner = nullptr;
     //
 
+    // model space bounds of every mesh, see calculate_bounds().
+    vec3 aabb_min = vec3(0.0f), aabb_max = vec3(0.0f);
+    bool bounds_ready = false;
+    void calculate_bounds();
+
+    // true once bake_animation was called, objects then play the baked clip instead of evaluating poses.
+    bool baked = false;
+
+    // plays the animation on every object of this model that has not chosen its own.
     void play_animation(const string& animation);
+    // skins every mesh with the animation at fps and stores the results in textures for default_vertex_baked.glsl.
+    // Must be called on the gl thread.  (see vertex_animation_texture)
+    void bake_animation(const string& animation, float fps);
+    animation* find_animation(const string& animation);
 
     inline RC<model*>* from_file(string file_path, bool animated) {
         return mesh::from_file(file_path, animated);
@@ -90,8 +111,8 @@ public:
 
     inline void extract_bone_weight_for_vertices(vector<vertex>* vertices, aiMesh* mesh, const aiScene* scene)
     {
-        // Set the max bones to 100
-		unsigned int numBones = mesh->mNumBones > 100 ? 100 : mesh->mNumBones;
+        // no cap on the bone count, the palette is sized to bone_counter. (see animator::upload_palette)
+		unsigned int numBones = mesh->mNumBones;
         int& bone_count_local = bone_counter;
 		// For each bone
 		for (unsigned int boneIndex = 0; boneIndex < numBones; ++boneIndex)
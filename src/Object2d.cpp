@@ -7,6 +7,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "Camera.h"
 #include "Window.h"
+#include "TextureStreamer.h"
 
 object2d::object2d(sprite* spr, camera * cam, vec2* position, float rotation, vec2* scale, rc_material mat, float depth)
 :
@@ -62,6 +63,7 @@ void object2d::render(camera& camera) {
     this->register_uniforms(); // register object level uniforms
 
     this->spr->tex->data->bind();
+    texture_streamer::request_full(this->spr->tex->data);
 
     glBindVertexArray(this->spr->gl_VAO);
 
@@ -12,6 +12,9 @@
 #include "SpotLight.h"
 #include "Model.h"
 #include "Animation.h"
+#include "Skinning.h"
+#include "ThreadPool.h"
+#include <functional>
 
 #define ATTENUATION_THRESHOLD 0.003
 
@@ -21,6 +24,92 @@ object3d::object3d(rc_model model_data, vec3* position, quaternion* rotation, ve
     }
 }
 
+object3d::~object3d() {
+    delete animation_player;
+}
+
+void object3d::play_animation(const string& name) {
+    animation* clip = this->model_data->data->find_animation(name);
+    if (!this->animation_player)
+        this->animation_player = new animator(nullptr);
+    this->animation_player->play(clip);
+    this->own_animation = true;
+}
+
+void object3d::update_animation(float dt) {
+    model* data = this->model_data->data;
+    if (data->baked) {
+        // the pose comes from the baked textures, only the clock is ours.
+        this->baked_time += dt;
+        return;
+    }
+    if (!this->animation_player)
+        this->animation_player = new animator(nullptr);
+    if (!this->own_animation && this->followed_generation != data->animation_generation) {
+        this->animation_player->play(data->current_animation);
+        this->followed_generation = data->animation_generation;
+    }
+    this->animation_player->update(dt);
+    if (this->refit_colliders_on_update)
+        this->refit_colliders();
+}
+
+vector<glm::vec3> object3d::get_skinned_vertices() {
+    vector<mesh*> meshes;
+    size_t total = 0;
+    std::function<void(mesh_dict*)> gather = [&](mesh_dict* dict) {
+        for (auto [_name, child] : *dict) {
+            if (std::holds_alternative<rc_mesh>(child)) {
+                mesh* m = std::get<rc_mesh>(child)->data;
+                meshes.push_back(m);
+                total += m->vertices ? m->vertices->size() : 0;
+            } else {
+                gather(std::get<rc_mesh_dict>(child)->data);
+            }
+        }
+    };
+    gather(this->model_data->data->mesh_data->data);
+
+    // without a pose every bone id is out of range and vertices keep their bind pose.
+    const glm::mat4* palette = nullptr;
+    size_t bone_count = 0;
+    if (this->animation_player && this->animation_player->current_animation) {
+        palette = this->animation_player->final_bone_matricies.data();
+        bone_count = this->animation_player->final_bone_matricies.size();
+    }
+
+    vector<glm::vec3> ret(total);
+    size_t offset = 0;
+    for (mesh* m : meshes) {
+        if (!m->vertices)
+            continue;
+        skin_vertices_parallel(m->vertices->data(), m->vertices->size(), palette, bone_count, ret.data() + offset, nullptr, thread_pool::get_global());
+        offset += m->vertices->size();
+    }
+    return ret;
+}
+
+void object3d::refit_colliders() {
+    // nothing moves the vertices without a pose, skinning would only reproduce the bind pose.
+    if (!this->animation_player || !this->animation_player->current_animation)
+        return;
+    vector<glm::vec3> points;
+    bool skinned = false;
+    for (auto col : this->colliders) {
+        // colliders made from a single mesh or by hand don't follow the model.
+        if (col->data->owner != this)
+            continue;
+        if (!skinned) {
+            points = this->get_skinned_vertices();
+            skinned = true;
+        }
+        if (auto box = dynamic_cast<collider_box*>(col->data))
+            box->refit(points);
+        else if (auto convex = dynamic_cast<collider_convex*>(col->data))
+            convex->refit(points);
+    }
+}
+
 std::ostream& operator<<(std::ostream& os, const object3d& self){
     os << "object3d< \"" << self.model_data->data->mesh_data->data->name << "\" { position: " << *self.position << "} >";
     return os;
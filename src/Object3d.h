@@ -2,6 +2,7 @@
 #include "Vec3.h"
 #include "Quaternion.h"
 #include <vector>
+#include <cstdint>
 #include "Material.h"
 #include "RC.h"
 #include <iostream>
@@ -16,6 +17,7 @@ class camera;
 class mesh_dict;
 class window;
 class model;
+class animator;
 
 typedef RC<model*>* rc_model;
 
@@ -25,7 +27,7 @@ public:
     object3d(){};
     object3d(rc_model model_data, vec3* position, quaternion* rotation, vec3* scale, rc_material mat = nullptr, RC<collider*>* collider = nullptr);
     
-    ~object3d(){}
+    ~object3d();
 
     rc_model model_data;
     vec3* position = nullptr;
@@ -36,9 +38,27 @@ public:
     vector<RC<collider*>*> colliders;
     octree<RC<collider*>*>* all_colliders;
     matrix4x4 model_matrix = get_model_matrix();
+    // this object's playback of the model's animations, created the first time it is animated.
+    animator* animation_player = nullptr;
+    // clock of the model's baked animation, plus an offset so instances don't move in lockstep.
+    float baked_time = 0.0f;
+    float baked_time_offset = 0.0f;
 
     void set_uniform(string name, uniform_type value);
 
+    // plays one of the model's animations on this object only, from the beginning.
+    void play_animation(const string& name);
+    // advances this object's animation, following the model's clip untill play_animation is called.
+    void update_animation(float dt);
+
+    // the model's vertices skinned with this object's current pose on the cpu, in model space and in the order of
+    // mesh_dict::gather_mesh_verticies.  Works without a gpu, for headless simulation.
+    vector<glm::vec3> get_skinned_vertices();
+    // refits the box and convex colliders made from this object's model to its current pose, does nothing without one.
+    void refit_colliders();
+    // calls refit_colliders after every animation update.  Rebuilding convex hulls every frame is costly.
+    bool refit_colliders_on_update = false;
+
     void render(camera& camera, window* window);
 
     friend std::ostream& operator<<(std::ostream& os, const object3d& self);
@@ -55,7 +75,10 @@ public:
         return model;
     }
 
-
+private:
+    bool own_animation = false;
+    uint64_t followed_generation = 0;
+public:
 
     inline bool check_collision_point(vec3 point) {
         for (auto collider : this->colliders) {
@@ -0,0 +1,118 @@
+#include "ParticleCollision.h"
+#include "Object3d.h"
+#include "Colliders.h"
+#include <cmath>
+
+float particle_collider_grid::cell_size = 8.0f;
+
+uint64_t particle_collider_grid::cell_key(int x, int y, int z) {
+    const uint64_t mask = (1 << 21) - 1;
+    return (static_cast<uint64_t>(x) & mask) | ((static_cast<uint64_t>(y) & mask) << 21) | ((static_cast<uint64_t>(z) & mask) << 42);
+}
+
+glm::ivec3 particle_collider_grid::cell_of(const glm::vec3& point) const {
+    return glm::ivec3(glm::floor(point / cell_size));
+}
+
+double particle_collider_grid::cell_count(const glm::vec3& low, const glm::vec3& high) const {
+    // in floating point, far away or huge bounds would overflow the cell coordinates.
+    glm::dvec3 span = glm::floor(glm::dvec3(high) / double(cell_size)) - glm::floor(glm::dvec3(low) / double(cell_size)) + 1.0;
+    return span.x * span.y * span.z;
+}
+
+bool particle_collider_grid::overlaps(uint32_t box, const glm::vec3& low, const glm::vec3& high) const {
+    return glm::all(glm::lessThanEqual(bounds[box].first, high)) && glm::all(glm::lessThanEqual(low, bounds[box].second));
+}
+
+void particle_collider_grid::build(const std::set<object3d*>& objects) {
+    boxes.clear();
+    bounds.clear();
+    oversized.clear();
+    // keeps the cells' vectors around, most frames fill the same ones again.  Cells left behind by moving
+    // colliders are dropped once they outnumber the used ones.
+    if (cells.size() > filled_cells * 4 + 64)
+        cells.clear();
+    for (auto& [key, cell] : cells)
+        cell.clear();
+
+    for (object3d* ob : objects) {
+        // model_matrix is only refreshed when the object renders, which happens after the particles update.
+        ob->get_model_matrix();
+        for (auto col : ob->colliders) {
+            auto box = dynamic_cast<collider_box*>(col->data);
+            if (!box)
+                continue;
+            if (box->owner && box->owner != ob)
+                box->owner->get_model_matrix();
+            // the same transform collider_box uses for its SAT tests.
+            glm::mat4 m = ((box->owner ? box->owner->model_matrix : matrix4x4(1.0f)).translate(box->offset) * matrix4x4(box->rotation)).scale(box->scale).mat;
+            glm::vec3 local_center = (box->upper_bounds.axis + box->lower_bounds.axis) * 0.5f;
+            glm::vec3 local_half = glm::abs(box->upper_bounds.axis - box->lower_bounds.axis) * 0.5f;
+
+            particle_box out;
+            glm::vec3 center = glm::vec3(m * glm::vec4(local_center, 1.0f));
+            glm::vec3 extent(0.0f);
+            for (int k = 0; k < 3; k++) {
+                glm::vec3 axis = glm::vec3(m[k]);
+                float length = glm::length(axis);
+                axis = length > 0.0f ? axis / length : glm::vec3(0.0f);
+                out.center[k] = center[k];
+                out.half_extents[k] = local_half[k] * length;
+                for (int a = 0; a < 3; a++)
+                    out.axes[k][a] = axis[a];
+                extent += glm::abs(axis) * out.half_extents[k];
+            }
+            uint32_t index = static_cast<uint32_t>(boxes.size());
+            boxes.push_back(out);
+            bounds.emplace_back(center - extent, center + extent);
+
+            if (cell_count(center - extent, center + extent) > MAX_BOX_CELLS) {
+                oversized.push_back(index);
+                continue;
+            }
+            glm::ivec3 low = cell_of(center - extent), high = cell_of(center + extent);
+            for (int x = low.x; x <= high.x; x++)
+                for (int y = low.y; y <= high.y; y++)
+                    for (int z = low.z; z <= high.z; z++)
+                        cells[cell_key(x, y, z)].push_back(index);
+        }
+    }
+    filled_cells = 0;
+    for (auto& [key, cell] : cells)
+        filled_cells += !cell.empty();
+    stamps.assign(boxes.size(), 0);
+    stamp = 0;
+}
+
+void particle_collider_grid::query(const glm::vec3& low, const glm::vec3& high, vector<particle_box>& out) {
+    if (boxes.empty())
+        return;
+    stamp++;
+    auto add = [&](uint32_t box) {
+        if (stamps[box] == stamp || !overlaps(box, low, high))
+            return;
+        stamps[box] = stamp;
+        out.push_back(boxes[box]);
+    };
+    for (uint32_t box : oversized)
+        add(box);
+
+    if (cell_count(low, high) > filled_cells) {
+        // the particles spread over more cells than are in use, checking every box is cheaper.
+        for (uint32_t box = 0; box < boxes.size(); box++)
+            add(box);
+        return;
+    }
+    glm::ivec3 first = cell_of(low), last = cell_of(high);
+    for (int x = first.x; x <= last.x; x++) {
+        for (int y = first.y; y <= last.y; y++) {
+            for (int z = first.z; z <= last.z; z++) {
+                auto found = cells.find(cell_key(x, y, z));
+                if (found == cells.end())
+                    continue;
+                for (uint32_t box : found->second)
+                    add(box);
+            }
+        }
+    }
+}
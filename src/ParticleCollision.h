@@ -0,0 +1,51 @@
+#pragma once
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "ParticleSimulation.h"
+
+using std::vector;
+
+class object3d;
+
+// Uniform grid over the world space bounds of the scene's box colliders, so emitters only collide with the boxes
+// near their particles instead of every collider in the scene.  The window rebuilds it once per frame when an
+// emitter collides with colliders. (see emitter::collide_colliders)
+
+class particle_collider_grid {
+public:
+    // rebuilds the grid from the collider_box colliders of objects, as oriented boxes.
+    void build(const std::set<object3d*>& objects);
+    // appends the boxes whose bounds overlap [low, high] to out, each once.
+    void query(const glm::vec3& low, const glm::vec3& high, vector<particle_box>& out);
+
+    inline size_t box_count() const {
+        return boxes.size();
+    }
+
+    // edge length of a cell in world units.  Boxes spanning more than MAX_BOX_CELLS cells are kept in a list
+    // every query checks instead.
+    static float cell_size;
+    static inline void set_cell_size(float size) {
+        cell_size = size;
+    }
+    static constexpr size_t MAX_BOX_CELLS = 512;
+private:
+    // cell coordinates to a key, 21 bits per axis.
+    static uint64_t cell_key(int x, int y, int z);
+    glm::ivec3 cell_of(const glm::vec3& point) const;
+    double cell_count(const glm::vec3& low, const glm::vec3& high) const;
+    bool overlaps(uint32_t box, const glm::vec3& low, const glm::vec3& high) const;
+
+    vector<particle_box> boxes;
+    vector<std::pair<glm::vec3, glm::vec3>> bounds;
+    std::unordered_map<uint64_t, vector<uint32_t>> cells;
+    vector<uint32_t> oversized;
+    size_t filled_cells = 0;
+    // the query each box was last added to, so boxes in several cells are only added once.
+    vector<uint32_t> stamps;
+    uint32_t stamp = 0;
+};
@@ -0,0 +1,46 @@
+#include "ParticleLod.h"
+#include "Emitter.h"
+#include "Camera.h"
+#include <cmath>
+
+bool particle_lod::enabled = true;
+float particle_lod::full_rate_distance = 30.0f;
+float particle_lod::min_rate = 0.1f;
+bool particle_lod::cull_offscreen = true;
+int particle_lod::coarse_interval = 4;
+
+void particle_lod::apply(emitter* ob, const camera& cam, float dt) {
+    size_t count = ob->particles.size();
+    auto step_now = [&]() {
+        ob->step = true;
+        ob->step_dt = dt + ob->pending_dt;
+        ob->pending_dt = 0.0f;
+        ob->pending_frames = 0;
+    };
+    if (!enabled) {
+        ob->visible = true;
+        ob->set_active(count);
+        step_now();
+        return;
+    }
+
+    glm::vec3 origin = ob->position->axis;
+    glm::vec3 low = ob->bounds_ready ? glm::min(ob->bounds_min, origin) : origin;
+    glm::vec3 high = ob->bounds_ready ? glm::max(ob->bounds_max, origin) : origin;
+    ob->visible = !cull_offscreen || cam.in_view(matrix4x4(1.0f), vec3(low), vec3(high));
+
+    float distance = glm::length(cam.position->axis - origin);
+    float fraction = distance > full_rate_distance ? std::max(min_rate, full_rate_distance / distance) : 1.0f;
+    ob->set_active(std::max<size_t>(1, static_cast<size_t>(std::ceil(count * std::min(fraction, 1.0f)))));
+
+    if (ob->visible) {
+        step_now();
+    } else if (coarse_interval <= 0) {
+        ob->step = false;
+    } else if (++ob->pending_frames >= coarse_interval) {
+        step_now();
+    } else {
+        ob->step = false;
+        ob->pending_dt += dt;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+
+class emitter;
+class camera;
+
+// Emitter level of detail.  Before the particles are simulated the window checks each emitter's bounds (its
+// particles after the last simulation, plus its origin) against the view.  Emitters outside it aren't drawn and
+// only simulate every coarse_interval frames, with the time they skipped, or not at all when it is 0.
+// Emitters farther than full_rate_distance keep fewer of their particles alive, down to min_rate of them.
+
+class particle_lod {
+public:
+    static bool enabled;
+    static inline void set_enabled(bool value) { enabled = value; }
+    static inline bool is_enabled() { return enabled; }
+
+    static float full_rate_distance, min_rate;
+    static inline void set_distance(float full_rate, float minimum) {
+        full_rate_distance = full_rate;
+        min_rate = minimum;
+    }
+    static bool cull_offscreen;
+    static inline void set_cull_offscreen(bool value) { cull_offscreen = value; }
+    static int coarse_interval;
+    static inline void set_coarse_interval(int frames) { coarse_interval = frames; }
+
+    // sets ob's lod for this frame: whether it is drawn, whether and by how long it is simulated and how many of
+    // its particles are active.  Respawns particles that become active, so one thread per emitter.
+    static void apply(emitter* ob, const camera& cam, float dt);
+};
@@ -0,0 +1,33 @@
+#include "ParticleProfiler.h"
+#include "Emitter.h"
+
+particle_stats particle_profiler::stats;
+
+void particle_profiler::record_frame(const vector<emitter*>& emitters) {
+    stats = particle_stats();
+    for (const emitter* ob : emitters) {
+        stats.emitters++;
+        stats.particles += ob->particles.size();
+        stats.culled_emitters += !ob->visible;
+        stats.skipped_emitters += !ob->step;
+        stats.reduced_emitters += ob->active < ob->particles.size();
+        if (ob->step)
+            stats.simulated_particles += ob->active;
+        if (ob->step && ob->visible)
+            stats.drawn_particles += ob->active;
+        if (ob->step && ob->collides()) {
+            stats.collision_emitters++;
+            stats.collisions += ob->collisions;
+            stats.collision_ms += ob->collision_ms;
+        }
+        if (!ob->sorted)
+            continue;
+        stats.sorted_emitters++;
+        stats.sorted_particles += ob->active;
+        switch (ob->last_sort) {
+            case particle_sorter::REUSED: stats.reused_orders++; break;
+            case particle_sorter::RADIX: stats.radix_sorts++; break;
+        }
+        stats.sort_ms += ob->sort_ms;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+using std::vector;
+
+class emitter;
+
+struct particle_stats {
+    // emitters emitting in the last frame and their particles.
+    size_t emitters = 0;
+    size_t particles = 0;
+    // what particle_lod did with them: emitters out of view, the ones of those not simulated this frame and the
+    // ones keeping fewer particles alive for their distance.
+    size_t culled_emitters = 0;
+    size_t skipped_emitters = 0;
+    size_t reduced_emitters = 0;
+    // active particles that were simulated and drawn.
+    size_t simulated_particles = 0;
+    size_t drawn_particles = 0;
+    // emitters with depth_sort on and their particles.
+    size_t sorted_emitters = 0;
+    size_t sorted_particles = 0;
+    // how each sorted emitter was ordered. (see particle_sorter)
+    size_t reused_orders = 0;
+    size_t radix_sorts = 0;
+    // time spent sorting, summed over the worker threads.
+    double sort_ms = 0.0;
+    // emitters that collided their particles, the particles that hit something and the time their update took
+    // with collision, summed over the worker threads.
+    size_t collision_emitters = 0;
+    size_t collisions = 0;
+    double collision_ms = 0.0;
+};
+
+// Per frame numbers on the particle simulation, filled in by the window after it simulates the emitters.
+
+class particle_profiler {
+public:
+    // sums the counters of the emitters emitting this frame.
+    static void record_frame(const vector<emitter*>& emitters);
+
+    static inline particle_stats get_stats() { return stats; }
+private:
+    static particle_stats stats;
+};
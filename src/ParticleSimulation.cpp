@@ -0,0 +1,400 @@
+#include "ParticleSimulation.h"
+#include <bit>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#if defined(__AVX__)
+#define LOXOC_PARTICLES_AVX
+#include <immintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define LOXOC_PARTICLES_SSE
+#include <xmmintrin.h>
+#endif
+
+void particle_buffer::resize(size_t count) {
+    for (vector<float>* component : {&position_x, &position_y, &position_z, &velocity_x, &velocity_y, &velocity_z, &life})
+        component->resize(count);
+}
+
+static inline void write_instance(const particle_buffer& particles, size_t i, float* instance) {
+    float* out = instance + i * PARTICLE_INSTANCE_FLOATS;
+    out[PARTICLE_POSITION_OFFSET] = particles.position_x[i];
+    out[PARTICLE_POSITION_OFFSET + 1] = particles.position_y[i];
+    out[PARTICLE_POSITION_OFFSET + 2] = particles.position_z[i];
+    out[PARTICLE_LIFE_OFFSET] = particles.life[i];
+}
+
+// Collision.  Both versions go through the shapes in the same order with the same arithmetic, so they agree
+// exactly: planes, then spheres, then boxes, each pushing the particle out along its normal by the depth it is in.
+// It runs inside the integration loop, right after a particle moves, so its state is only loaded and stored once.
+
+// Collides particle i with every obstacle, returns whether it hit any.  KILL is left to the caller.
+static inline bool collide_particle_scalar(particle_buffer& particles, size_t i, const particle_obstacles& obstacles, CollisionResponse response, float bounce) {
+    float p[3] = {particles.position_x[i], particles.position_y[i], particles.position_z[i]};
+    float v[3] = {particles.velocity_x[i], particles.velocity_y[i], particles.velocity_z[i]};
+    bool hit = false;
+    auto respond = [&](const float* n, float depth) {
+        hit = true;
+        if (response == CollisionResponse::KILL)
+            return;
+        for (int a = 0; a < 3; a++)
+            p[a] = p[a] + n[a] * depth;
+        if (response == CollisionResponse::STICK) {
+            v[0] = v[1] = v[2] = 0.0f;
+            return;
+        }
+        float vn = v[0] * n[0] + v[1] * n[1] + v[2] * n[2];
+        if (vn < 0.0f)
+            for (int a = 0; a < 3; a++)
+                v[a] = v[a] - n[a] * (bounce * vn);
+    };
+
+    for (const particle_plane& plane : obstacles.planes) {
+        float d = p[0] * plane.normal[0] + p[1] * plane.normal[1] + p[2] * plane.normal[2] + plane.distance;
+        if (d < 0.0f)
+            respond(plane.normal, 0.0f - d);
+    }
+    for (const particle_sphere& sphere : obstacles.spheres) {
+        float d[3] = {p[0] - sphere.center[0], p[1] - sphere.center[1], p[2] - sphere.center[2]};
+        float length2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        if (!(length2 < sphere.radius * sphere.radius))
+            continue;
+        float length = std::sqrt(length2);
+        // a particle right at the center goes out the top.
+        float n[3] = {0.0f, 1.0f, 0.0f};
+        if (0.0f < length) {
+            float inverse = 1.0f / length;
+            for (int a = 0; a < 3; a++)
+                n[a] = d[a] * inverse;
+        }
+        respond(n, sphere.radius - length);
+    }
+    for (const particle_box& box : obstacles.boxes) {
+        float d[3] = {p[0] - box.center[0], p[1] - box.center[1], p[2] - box.center[2]};
+        float q[3], gap[3];
+        for (int k = 0; k < 3; k++) {
+            q[k] = d[0] * box.axes[k][0] + d[1] * box.axes[k][1] + d[2] * box.axes[k][2];
+            gap[k] = box.half_extents[k] - std::max(q[k], 0.0f - q[k]);
+        }
+        if (!(0.0f < gap[0] && 0.0f < gap[1] && 0.0f < gap[2]))
+            continue;
+        // out through the nearest face.
+        int k = 0;
+        for (int j = 1; j < 3; j++)
+            if (gap[j] < gap[k])
+                k = j;
+        float sign = q[k] < 0.0f ? -1.0f : 1.0f;
+        float n[3] = {box.axes[k][0] * sign, box.axes[k][1] * sign, box.axes[k][2] * sign};
+        respond(n, gap[k]);
+    }
+
+    if (hit) {
+        particles.position_x[i] = p[0];
+        particles.position_y[i] = p[1];
+        particles.position_z[i] = p[2];
+        particles.velocity_x[i] = v[0];
+        particles.velocity_y[i] = v[1];
+        particles.velocity_z[i] = v[2];
+    }
+    return hit;
+}
+
+size_t integrate_particles_scalar(particle_buffer& particles, size_t begin, size_t end, float dt, float decay_rate, float velocity_decay, float* instance, vector<uint32_t>& dead, const particle_collision& collision) {
+    float life_step = decay_rate * dt;
+    float velocity_step = velocity_decay * dt;
+    bool collide = collision.active();
+    float bounce = 1.0f + collision.restitution;
+    size_t hits = 0;
+    for (size_t i = begin; i < end; i++) {
+        particles.life[i] -= life_step;
+        particles.position_x[i] += particles.velocity_x[i] * dt;
+        particles.position_y[i] += particles.velocity_y[i] * dt;
+        particles.position_z[i] += particles.velocity_z[i] * dt;
+        particles.velocity_x[i] -= velocity_step;
+        particles.velocity_y[i] -= velocity_step;
+        particles.velocity_z[i] -= velocity_step;
+        if (collide && collide_particle_scalar(particles, i, *collision.obstacles, collision.response, bounce)) {
+            hits++;
+            if (collision.response == CollisionResponse::KILL && 0.0f < particles.life[i])
+                particles.life[i] = 0.0f;
+        }
+        write_instance(particles, i, instance);
+        if (particles.life[i] <= 0.0f)
+            dead.push_back(static_cast<uint32_t>(i));
+    }
+    return hits;
+}
+
+#if defined(LOXOC_PARTICLES_AVX)
+typedef __m256 lanes;
+static constexpr size_t LANE_COUNT = 8;
+static inline lanes lanes_load(const float* p) { return _mm256_loadu_ps(p); }
+static inline void lanes_store(float* p, lanes v) { _mm256_storeu_ps(p, v); }
+static inline lanes lanes_set(float v) { return _mm256_set1_ps(v); }
+static inline lanes lanes_add(lanes a, lanes b) { return _mm256_add_ps(a, b); }
+static inline lanes lanes_sub(lanes a, lanes b) { return _mm256_sub_ps(a, b); }
+static inline lanes lanes_mul(lanes a, lanes b) { return _mm256_mul_ps(a, b); }
+static inline unsigned lanes_not_positive(lanes v) { return _mm256_movemask_ps(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_LE_OQ)); }
+static inline lanes lanes_div(lanes a, lanes b) { return _mm256_div_ps(a, b); }
+static inline lanes lanes_max(lanes a, lanes b) { return _mm256_max_ps(a, b); }
+static inline lanes lanes_sqrt(lanes v) { return _mm256_sqrt_ps(v); }
+// comparisons give masks, all bits set in the lanes where they hold.
+static inline lanes lanes_less(lanes a, lanes b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline lanes lanes_and(lanes a, lanes b) { return _mm256_and_ps(a, b); }
+static inline lanes lanes_or(lanes a, lanes b) { return _mm256_or_ps(a, b); }
+static inline lanes lanes_select(lanes mask, lanes a, lanes b) { return _mm256_blendv_ps(b, a, mask); }
+static inline unsigned lanes_mask(lanes mask) { return _mm256_movemask_ps(mask); }
+#elif defined(LOXOC_PARTICLES_SSE)
+typedef __m128 lanes;
+static constexpr size_t LANE_COUNT = 4;
+static inline lanes lanes_load(const float* p) { return _mm_loadu_ps(p); }
+static inline void lanes_store(float* p, lanes v) { _mm_storeu_ps(p, v); }
+static inline lanes lanes_set(float v) { return _mm_set1_ps(v); }
+static inline lanes lanes_add(lanes a, lanes b) { return _mm_add_ps(a, b); }
+static inline lanes lanes_sub(lanes a, lanes b) { return _mm_sub_ps(a, b); }
+static inline lanes lanes_mul(lanes a, lanes b) { return _mm_mul_ps(a, b); }
+static inline unsigned lanes_not_positive(lanes v) { return _mm_movemask_ps(_mm_cmple_ps(v, _mm_setzero_ps())); }
+static inline lanes lanes_div(lanes a, lanes b) { return _mm_div_ps(a, b); }
+static inline lanes lanes_max(lanes a, lanes b) { return _mm_max_ps(a, b); }
+static inline lanes lanes_sqrt(lanes v) { return _mm_sqrt_ps(v); }
+// comparisons give masks, all bits set in the lanes where they hold.
+static inline lanes lanes_less(lanes a, lanes b) { return _mm_cmplt_ps(a, b); }
+static inline lanes lanes_and(lanes a, lanes b) { return _mm_and_ps(a, b); }
+static inline lanes lanes_or(lanes a, lanes b) { return _mm_or_ps(a, b); }
+static inline lanes lanes_select(lanes mask, lanes a, lanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline unsigned lanes_mask(lanes mask) { return _mm_movemask_ps(mask); }
+#endif
+
+#if defined(LOXOC_PARTICLES_AVX) || defined(LOXOC_PARTICLES_SSE)
+#if defined(_MSC_VER)
+#define LOXOC_NOINLINE __declspec(noinline)
+#else
+#define LOXOC_NOINLINE __attribute__((noinline))
+#endif
+
+// Whether any lane is inside any obstacle, with the same inside tests collide_lanes makes.  Most blocks hit
+// nothing, this keeps them to a few multiplies per shape with the particles still in registers.
+static inline bool lanes_touch(const lanes* p, const particle_obstacles& obstacles) {
+    const lanes zero = lanes_set(0.0f);
+    lanes inside = zero;
+    for (const particle_plane& plane : obstacles.planes) {
+        lanes d = lanes_add(lanes_add(lanes_add(lanes_mul(p[0], lanes_set(plane.normal[0])), lanes_mul(p[1], lanes_set(plane.normal[1]))), lanes_mul(p[2], lanes_set(plane.normal[2]))), lanes_set(plane.distance));
+        inside = lanes_or(inside, lanes_less(d, zero));
+    }
+    for (const particle_sphere& sphere : obstacles.spheres) {
+        lanes d[3];
+        for (int a = 0; a < 3; a++)
+            d[a] = lanes_sub(p[a], lanes_set(sphere.center[a]));
+        lanes length2 = lanes_add(lanes_add(lanes_mul(d[0], d[0]), lanes_mul(d[1], d[1])), lanes_mul(d[2], d[2]));
+        inside = lanes_or(inside, lanes_less(length2, lanes_set(sphere.radius * sphere.radius)));
+    }
+    for (const particle_box& box : obstacles.boxes) {
+        lanes d[3];
+        for (int a = 0; a < 3; a++)
+            d[a] = lanes_sub(p[a], lanes_set(box.center[a]));
+        // nothing outside the sphere around the box can be in it, padded against rounding.
+        float reach2 = (box.half_extents[0] * box.half_extents[0] + box.half_extents[1] * box.half_extents[1] + box.half_extents[2] * box.half_extents[2]) * 1.001f;
+        lanes length2 = lanes_add(lanes_add(lanes_mul(d[0], d[0]), lanes_mul(d[1], d[1])), lanes_mul(d[2], d[2]));
+        if (!lanes_mask(lanes_less(length2, lanes_set(reach2))))
+            continue;
+        lanes in_gap[3];
+        for (int k = 0; k < 3; k++) {
+            lanes q = lanes_add(lanes_add(lanes_mul(d[0], lanes_set(box.axes[k][0])), lanes_mul(d[1], lanes_set(box.axes[k][1]))), lanes_mul(d[2], lanes_set(box.axes[k][2])));
+            in_gap[k] = lanes_less(zero, lanes_sub(lanes_set(box.half_extents[k]), lanes_max(q, lanes_sub(zero, q))));
+        }
+        inside = lanes_or(inside, lanes_and(lanes_and(in_gap[0], in_gap[1]), in_gap[2]));
+    }
+    return lanes_mask(inside) != 0;
+}
+
+// collide_particle_scalar over a block of particles, returns a mask of the lanes that hit something.  Kept out
+// of line so the response code doesn't crowd the registers of the integration loop.
+static LOXOC_NOINLINE lanes collide_lanes(lanes* p, lanes* v, const particle_obstacles& obstacles, CollisionResponse response, lanes bounce) {
+    const lanes zero = lanes_set(0.0f), one = lanes_set(1.0f), minus_one = lanes_set(-1.0f);
+    lanes hit = zero;
+    // lanes outside the shape add and subtract zeros, which leaves them as they were.
+    auto respond = [&](lanes inside, const lanes* n, lanes depth) {
+        hit = lanes_or(hit, inside);
+        if (response == CollisionResponse::KILL)
+            return;
+        for (int a = 0; a < 3; a++)
+            p[a] = lanes_add(p[a], lanes_select(inside, lanes_mul(n[a], depth), zero));
+        if (response == CollisionResponse::STICK) {
+            for (int a = 0; a < 3; a++)
+                v[a] = lanes_select(inside, zero, v[a]);
+            return;
+        }
+        lanes vn = lanes_add(lanes_add(lanes_mul(v[0], n[0]), lanes_mul(v[1], n[1])), lanes_mul(v[2], n[2]));
+        lanes push = lanes_select(lanes_and(inside, lanes_less(vn, zero)), lanes_mul(bounce, vn), zero);
+        for (int a = 0; a < 3; a++)
+            v[a] = lanes_sub(v[a], lanes_mul(n[a], push));
+    };
+
+    for (const particle_plane& plane : obstacles.planes) {
+        lanes n[3] = {lanes_set(plane.normal[0]), lanes_set(plane.normal[1]), lanes_set(plane.normal[2])};
+        lanes d = lanes_add(lanes_add(lanes_add(lanes_mul(p[0], n[0]), lanes_mul(p[1], n[1])), lanes_mul(p[2], n[2])), lanes_set(plane.distance));
+        lanes inside = lanes_less(d, zero);
+        if (lanes_mask(inside))
+            respond(inside, n, lanes_sub(zero, d));
+    }
+    for (const particle_sphere& sphere : obstacles.spheres) {
+        lanes d[3];
+        for (int a = 0; a < 3; a++)
+            d[a] = lanes_sub(p[a], lanes_set(sphere.center[a]));
+        lanes length2 = lanes_add(lanes_add(lanes_mul(d[0], d[0]), lanes_mul(d[1], d[1])), lanes_mul(d[2], d[2]));
+        lanes inside = lanes_less(length2, lanes_set(sphere.radius * sphere.radius));
+        if (!lanes_mask(inside))
+            continue;
+        lanes length = lanes_sqrt(length2);
+        lanes off_center = lanes_less(zero, length);
+        lanes inverse = lanes_div(one, length);
+        lanes n[3] = {
+            lanes_select(off_center, lanes_mul(d[0], inverse), zero),
+            lanes_select(off_center, lanes_mul(d[1], inverse), one),
+            lanes_select(off_center, lanes_mul(d[2], inverse), zero)
+        };
+        respond(inside, n, lanes_sub(lanes_set(sphere.radius), length));
+    }
+    for (const particle_box& box : obstacles.boxes) {
+        lanes d[3], q[3], gap[3];
+        for (int a = 0; a < 3; a++)
+            d[a] = lanes_sub(p[a], lanes_set(box.center[a]));
+        for (int k = 0; k < 3; k++) {
+            q[k] = lanes_add(lanes_add(lanes_mul(d[0], lanes_set(box.axes[k][0])), lanes_mul(d[1], lanes_set(box.axes[k][1]))), lanes_mul(d[2], lanes_set(box.axes[k][2])));
+            gap[k] = lanes_sub(lanes_set(box.half_extents[k]), lanes_max(q[k], lanes_sub(zero, q[k])));
+        }
+        lanes inside = lanes_and(lanes_and(lanes_less(zero, gap[0]), lanes_less(zero, gap[1])), lanes_less(zero, gap[2]));
+        if (!lanes_mask(inside))
+            continue;
+        // out through the nearest face.
+        auto face_normal = [&](int k, int a) {
+            return lanes_mul(lanes_set(box.axes[k][a]), lanes_select(lanes_less(q[k], zero), minus_one, one));
+        };
+        lanes depth = gap[0];
+        lanes n[3] = {face_normal(0, 0), face_normal(0, 1), face_normal(0, 2)};
+        for (int k = 1; k < 3; k++) {
+            lanes nearer = lanes_less(gap[k], depth);
+            depth = lanes_select(nearer, gap[k], depth);
+            for (int a = 0; a < 3; a++)
+                n[a] = lanes_select(nearer, face_normal(k, a), n[a]);
+        }
+        respond(inside, n, depth);
+    }
+
+    return hit;
+}
+#endif
+
+size_t integrate_particles(particle_buffer& particles, size_t begin, size_t end, float dt, float decay_rate, float velocity_decay, float* instance, vector<uint32_t>& dead, const particle_collision& collision) {
+#if defined(LOXOC_PARTICLES_AVX) || defined(LOXOC_PARTICLES_SSE)
+    lanes delta = lanes_set(dt);
+    lanes life_step = lanes_set(decay_rate * dt);
+    lanes velocity_step = lanes_set(velocity_decay * dt);
+    const lanes zero = lanes_set(0.0f);
+    const lanes bounce = lanes_set(1.0f + collision.restitution);
+    bool collide = collision.active();
+    size_t hits = 0;
+    float* position[3] = {particles.position_x.data(), particles.position_y.data(), particles.position_z.data()};
+    float* velocity[3] = {particles.velocity_x.data(), particles.velocity_y.data(), particles.velocity_z.data()};
+    size_t i = begin;
+    for (; i + LANE_COUNT <= end; i += LANE_COUNT) {
+        lanes life = lanes_sub(lanes_load(&particles.life[i]), life_step);
+        lanes p[3], v[3];
+        for (int axis = 0; axis < 3; axis++) {
+            v[axis] = lanes_load(velocity[axis] + i);
+            p[axis] = lanes_add(lanes_load(position[axis] + i), lanes_mul(v[axis], delta));
+            v[axis] = lanes_sub(v[axis], velocity_step);
+        }
+        if (collide && lanes_touch(p, *collision.obstacles)) {
+            // copies, so p and v don't need an address and stay in registers on the common path.
+            lanes hit_p[3] = {p[0], p[1], p[2]}, hit_v[3] = {v[0], v[1], v[2]};
+            lanes hit = collide_lanes(hit_p, hit_v, *collision.obstacles, collision.response, bounce);
+            for (int axis = 0; axis < 3; axis++) {
+                p[axis] = hit_p[axis];
+                v[axis] = hit_v[axis];
+            }
+            hits += std::popcount(lanes_mask(hit));
+            if (collision.response == CollisionResponse::KILL)
+                life = lanes_select(lanes_and(hit, lanes_less(zero, life)), zero, life);
+        }
+        lanes_store(&particles.life[i], life);
+        for (int axis = 0; axis < 3; axis++) {
+            lanes_store(position[axis] + i, p[axis]);
+            lanes_store(velocity[axis] + i, v[axis]);
+        }
+        // the instance layout is interleaved, so the results go out a particle at a time while they're still in cache.
+        for (size_t k = i; k < i + LANE_COUNT; k++)
+            write_instance(particles, k, instance);
+        for (unsigned mask = lanes_not_positive(life); mask; mask &= mask - 1)
+            dead.push_back(static_cast<uint32_t>(i + std::countr_zero(mask)));
+    }
+    return hits + integrate_particles_scalar(particles, i, end, dt, decay_rate, velocity_decay, instance, dead, collision);
+#else
+    return integrate_particles_scalar(particles, begin, end, dt, decay_rate, velocity_decay, instance, dead, collision);
+#endif
+}
+
+// maps a float to an unsigned key that sorts the other way round: larger floats get smaller keys.
+static inline uint32_t descending_key(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // flip every bit of negatives and only the sign of positives to get ascending keys, then invert them.
+    uint32_t ascending = bits ^ ((bits >> 31) ? 0xffffffffu : 0x80000000u);
+    return ~ascending;
+}
+
+particle_sorter::sort_method particle_sorter::sort(const float* depth, size_t count) {
+    if (order.size() != count) {
+        order.resize(count);
+        for (size_t i = 0; i < count; i++)
+            order[i] = static_cast<uint32_t>(i);
+    }
+    return radix_sort(depth, count) ? RADIX : REUSED;
+}
+
+bool particle_sorter::radix_sort(const float* depth, size_t count) {
+    if (count < 2)
+        return false;
+    constexpr int BITS = 11;
+    constexpr size_t BUCKETS = 1 << BITS;
+    keys.resize(count);
+    // keys follow the current order, so equal keys stay in it.  Checking them against their neighbour here is
+    // what catches an order that is still sorted, it costs a compare on values that are already loaded.
+    bool sorted = true;
+    keys[0] = descending_key(depth[order[0]]);
+    for (size_t i = 1; i < count; i++) {
+        keys[i] = descending_key(depth[order[i]]);
+        sorted &= keys[i] >= keys[i - 1];
+    }
+    if (sorted)
+        return false;
+    key_scratch.resize(count);
+    order_scratch.resize(count);
+
+    size_t histograms[3][BUCKETS] = {};
+    for (size_t i = 0; i < count; i++)
+        for (int pass = 0; pass < 3; pass++)
+            histograms[pass][(keys[i] >> (pass * BITS)) & (BUCKETS - 1)]++;
+
+    for (int pass = 0; pass < 3; pass++) {
+        size_t* histogram = histograms[pass];
+        // a pass where every key has the same digit leaves the order as it is.
+        if (histogram[(keys[0] >> (pass * BITS)) & (BUCKETS - 1)] == count)
+            continue;
+        size_t offset = 0;
+        for (size_t b = 0; b < BUCKETS; b++) {
+            size_t n = histogram[b];
+            histogram[b] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t dest = histogram[(keys[i] >> (pass * BITS)) & (BUCKETS - 1)]++;
+            key_scratch[dest] = keys[i];
+            order_scratch[dest] = order[i];
+        }
+        keys.swap(key_scratch);
+        order.swap(order_scratch);
+    }
+    return true;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using std::vector;
+
+// Layout of one particle in the instance buffer, the attributes emitter::set_instance_attributes sets up.
+#define PARTICLE_INSTANCE_FLOATS 11
+#define PARTICLE_POSITION_OFFSET 0
+#define PARTICLE_COLOR_OFFSET 3
+#define PARTICLE_SCALE_OFFSET 7
+#define PARTICLE_LIFE_OFFSET 9
+#define PARTICLE_STARTING_LIFE_OFFSET 10
+
+// particles per simulation job, large emitters are split into chunks of this many so they spread over threads.
+#define PARTICLE_CHUNK 16384
+
+// The particle state the simulation touches every frame, one array per component so the kernels work through
+// 4 (sse) or 8 (avx) particles at a time.  Color, scale and starting life don't change during a particle's life,
+// they are written straight into the instance data when it spawns and never read back.
+struct particle_buffer {
+    vector<float> position_x, position_y, position_z;
+    vector<float> velocity_x, velocity_y, velocity_z;
+    vector<float> life;
+
+    inline size_t size() const {
+        return life.size();
+    }
+
+    void resize(size_t count);
+};
+
+// What happens to a particle that ends up inside a collision shape.
+enum class CollisionResponse {
+    // no collision.
+    NONE,
+    // pushed out of the shape and the velocity into it reflected, scaled by the restitution.
+    BOUNCE,
+    // pushed out of the shape and stopped.
+    STICK,
+    // dies and respawns with the others.
+    KILL
+};
+
+// Collision shapes in world space.  A particle is inside a plane when dot(normal, p) + distance < 0, normals
+// and box axes must be unit length.
+struct particle_plane {
+    float normal[3];
+    float distance;
+};
+
+struct particle_sphere {
+    float center[3];
+    float radius;
+};
+
+// an oriented box: center + axes[i] * t for t in [-half_extents[i], half_extents[i]].
+struct particle_box {
+    float center[3];
+    float axes[3][3];
+    float half_extents[3];
+};
+
+struct particle_obstacles {
+    vector<particle_plane> planes;
+    vector<particle_sphere> spheres;
+    vector<particle_box> boxes;
+
+    inline bool empty() const {
+        return planes.empty() && spheres.empty() && boxes.empty();
+    }
+};
+
+// How integrate_particles collides the particles it moves, nothing when the response is NONE or there are no obstacles.
+struct particle_collision {
+    const particle_obstacles* obstacles = nullptr;
+    CollisionResponse response = CollisionResponse::NONE;
+    float restitution = 0.0f;
+
+    inline bool active() const {
+        return obstacles && response != CollisionResponse::NONE && !obstacles->empty();
+    }
+};
+
+// Advances particles [begin, end) by dt: life drops by decay_rate * dt, positions move by their velocity and
+// every velocity axis drops by velocity_decay * dt.  With an active collision each particle is then tested
+// against the obstacles while its state is still in registers, a shape at a time over 4 or 8 particles, and the
+// ones that hit something get the response.  Position and life are written to instance, which holds
+// PARTICLE_INSTANCE_FLOATS floats per particle starting at particle 0.  The indices of particles whose life
+// ran out (or that were killed by a collision) are appended to dead for the caller to respawn, reserve it up
+// front to keep the frame allocation free.  Returns the number of particles that hit something.
+size_t integrate_particles(particle_buffer& particles, size_t begin, size_t end, float dt, float decay_rate, float velocity_decay, float* instance, vector<uint32_t>& dead, const particle_collision& collision = particle_collision());
+// plain scalar version of integrate_particles, the reference the simd path is checked against.
+size_t integrate_particles_scalar(particle_buffer& particles, size_t begin, size_t end, float dt, float decay_rate, float velocity_decay, float* instance, vector<uint32_t>& dead, const particle_collision& collision = particle_collision());
+
+// Back to front draw order for one emitter's particles, kept between frames.
+// Each frame is a full radix sort, started from last frame's order so particles at the same depth don't swap.
+// Particles move past many of their neighbours every frame, so there's no cheaper partial fix up worth trying,
+// but an order that is still sorted is noticed while the keys are built and kept without the sorting passes.
+class particle_sorter {
+public:
+    enum sort_method {
+        // last frame's order was still sorted.
+        REUSED,
+        // stable least significant digit radix sort of the 32 bit float keys, 3 passes of 11 bits.
+        RADIX
+    };
+
+    // sorts order so depth[order[i]] never increases.  Particles at the same depth keep last frame's order, so
+    // they don't flicker.  depth holds count values, order is reset when count changes.
+    sort_method sort(const float* depth, size_t count);
+
+    // indices of the particles, farthest first.
+    vector<uint32_t> order;
+private:
+    // returns false when the keys were already in order and nothing was moved.
+    bool radix_sort(const float* depth, size_t count);
+
+    vector<uint32_t> keys, key_scratch, order_scratch;
+};
@@ -0,0 +1,221 @@
+#include "ProgramCache.h"
+#include "ResourceCache.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// bump when the layout of program_binary_header changes.
+static const uint32_t PROGRAM_CACHE_VERSION = 1;
+static const char PROGRAM_CACHE_MAGIC[4] = {'L', 'X', 'P', 'B'};
+
+struct program_binary_header {
+    char magic[4];
+    uint32_t version;
+    uint64_t driver_hash;
+    uint64_t source_key;
+    uint32_t format;
+    uint32_t length;
+};
+
+static string default_directory() {
+    if (const char* env = std::getenv("LOXOC_PROGRAM_CACHE"))
+        return env;
+    std::error_code ec;
+    fs::path tmp = fs::temp_directory_path(ec);
+    if (ec)
+        tmp = ".";
+    return (tmp / "loxoc_program_cache").string();
+}
+
+std::mutex program_binary_cache::lock;
+string program_binary_cache::directory = default_directory();
+bool program_binary_cache::enabled = true;
+program_cache_stats program_binary_cache::stats;
+
+bool program_binary_cache::supported() {
+    static int formats = -1;
+    if (formats < 0) {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+        formats = count;
+        stats.unsupported = formats == 0;
+    }
+    return formats > 0;
+}
+
+uint64_t program_binary_cache::driver_hash() {
+    static uint64_t hash = 0;
+    if (hash == 0) {
+        for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION}) {
+            const GLubyte* value = glGetString(name);
+            hash = content_hash(value ? reinterpret_cast<const char*>(value) : "", hash ? hash : 14695981039346656037ull);
+        }
+    }
+    return hash;
+}
+
+string program_binary_cache::entry_path(uint64_t source_key) {
+    char name[40];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hash_combine(source_key, driver_hash())));
+    return (fs::path(directory) / name).string();
+}
+
+void program_binary_cache::prepare_program(GLuint program) {
+    if (enabled && supported())
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+GLuint program_binary_cache::load(uint64_t source_key) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!enabled || !supported())
+        return 0;
+
+    string path = entry_path(source_key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        stats.misses++;
+        return 0;
+    }
+
+    program_binary_header header;
+    std::vector<char> blob;
+    bool valid = bool(file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        && std::memcmp(header.magic, PROGRAM_CACHE_MAGIC, 4) == 0
+        && header.version == PROGRAM_CACHE_VERSION
+        && header.driver_hash == driver_hash()
+        && header.source_key == source_key;
+    if (valid) {
+        blob.resize(header.length);
+        valid = bool(file.read(blob.data(), header.length));
+    }
+    file.close();
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, blob.data(), static_cast<GLsizei>(blob.size()));
+        GLint success = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    if (!program) {
+        // stale or corrupt entry, drop it so the fresh link replaces it.
+        std::error_code ec;
+        fs::remove(path, ec);
+        stats.rejected++;
+        stats.misses++;
+        return 0;
+    }
+    stats.hits++;
+    return program;
+}
+
+void program_binary_cache::store(uint64_t source_key, GLuint program) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!enabled || !supported())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> blob(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, blob.data());
+    if (written <= 0)
+        return;
+
+    program_binary_header header;
+    std::memcpy(header.magic, PROGRAM_CACHE_MAGIC, 4);
+    header.version = PROGRAM_CACHE_VERSION;
+    header.driver_hash = driver_hash();
+    header.source_key = source_key;
+    header.format = format;
+    header.length = static_cast<uint32_t>(written);
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    string path = entry_path(source_key);
+    // write next to the final path and rename so a crash never leaves a truncated entry behind.
+    string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Could not write program cache entry: " << tmp_path << "\n";
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(blob.data(), written);
+        if (!file) {
+            file.close();
+            fs::remove(tmp_path, ec);
+            return;
+        }
+    }
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        fs::remove(tmp_path, ec);
+        return;
+    }
+    stats.stored++;
+}
+
+void program_binary_cache::set_directory(const string& path) {
+    std::lock_guard<std::mutex> guard(lock);
+    directory = path;
+}
+
+string program_binary_cache::get_directory() {
+    std::lock_guard<std::mutex> guard(lock);
+    return directory;
+}
+
+void program_binary_cache::set_enabled(bool value) {
+    std::lock_guard<std::mutex> guard(lock);
+    enabled = value;
+}
+
+bool program_binary_cache::is_enabled() {
+    std::lock_guard<std::mutex> guard(lock);
+    return enabled;
+}
+
+size_t program_binary_cache::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    size_t removed = 0;
+    std::error_code ec;
+    if (!fs::is_directory(directory, ec))
+        return 0;
+    for (auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.path().extension() == ".bin" || entry.path().extension() == ".tmp") {
+            std::error_code remove_ec;
+            if (fs::remove(entry.path(), remove_ec))
+                removed++;
+        }
+    }
+    return removed;
+}
+
+program_cache_stats program_binary_cache::get_stats() {
+    std::lock_guard<std::mutex> guard(lock);
+    return stats;
+}
+
+void program_binary_cache::reset_stats() {
+    std::lock_guard<std::mutex> guard(lock);
+    bool unsupported = stats.unsupported;
+    stats = program_cache_stats();
+    stats.unsupported = unsupported;
+}
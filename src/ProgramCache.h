@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include "glad/gl.h"
+
+using std::string;
+
+struct program_cache_stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    // binaries found on disk but refused by the driver (driver update, different gpu etc.)
+    size_t rejected = 0;
+    size_t stored = 0;
+    // true when the driver exposes no program binary formats, the cache then does nothing.
+    bool unsupported = false;
+};
+
+// Persists linked shader programs on disk with glGetProgramBinary so later launches can skip compiling and linking.
+// Entries are keyed by the program's source hash (see resource_cache::program_key) combined with the gl vendor,
+// renderer and version strings.  The binary format id is stored with each blob.  When the driver rejects a binary
+// the file is removed and the caller falls back to compiling from source.
+
+class program_binary_cache {
+public:
+    // Returns a linked program created from the cached binary, or 0 on a miss.  Gl thread only.
+    static GLuint load(uint64_t source_key);
+    // Writes the program's binary to disk.  The program should have been linked with
+    // GL_PROGRAM_BINARY_RETRIEVABLE_HINT set, see prepare_program().  Gl thread only.
+    static void store(uint64_t source_key, GLuint program);
+    // Call on a freshly created program before linking it.
+    static void prepare_program(GLuint program);
+
+    static void set_directory(const string& path);
+    static string get_directory();
+    static void set_enabled(bool value);
+    static bool is_enabled();
+    // deletes every cached binary in the cache directory.
+    static size_t clear();
+
+    static program_cache_stats get_stats();
+    static void reset_stats();
+private:
+    static bool supported();
+    static uint64_t driver_hash();
+    static string entry_path(uint64_t source_key);
+
+    static std::mutex lock;
+    static string directory;
+    static bool enabled;
+    static program_cache_stats stats;
+};
@@ -1,6 +1,9 @@
 #pragma once
 #include <iostream>
+#include <atomic>
 
+// The count is atomic since pool workers take references to cached shaders and textures during background
+// imports while the gl thread and python release others.
 template<typename T>
 class RC {
 public:
@@ -10,26 +13,26 @@ public:
     //     delete this->data;
     // }
     inline T inc(){
-        this->refcount++;
+        this->refcount.fetch_add(1, std::memory_order_relaxed);
         return data;
     }
-    inline void dec(){
-        this->refcount--;
-        if (this->refcount == 0) {
+    // returns the count left after the release.
+    inline int dec(){
+        int remaining = this->refcount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (remaining == 0) {
             delete this->data;
-        } else if (this->refcount < 0) {
-            std::cout << "There has been a fatal reference counting bug, please open an issue on the github.  REFCOUNT " << this->refcount << "\n";
+        } else if (remaining < 0) {
+            std::cout << "There has been a fatal reference counting bug, please open an issue on the github.  REFCOUNT " << remaining << "\n";
         }
+        return remaining;
     }
     T data;
-    int refcount;
+    std::atomic<int> refcount;
 };
 
 template<typename T>
 constexpr void RC_collect(RC<T*>* rc) {
-    rc->dec();
-    if (rc->refcount == 0) {
+    if (rc->dec() == 0) {
         delete rc;
     }
 }
-    
\ No newline at end of file
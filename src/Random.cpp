@@ -0,0 +1,91 @@
+#include "Random.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOXOC_RANDOM_SSE
+#include <emmintrin.h>
+#endif
+
+static inline uint64_t splitmix64(uint64_t& x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+void random_stream::set_seed(uint64_t new_seed) {
+    seed = new_seed;
+    uint64_t x = new_seed;
+    for (size_t lane = 0; lane < LANES; lane++) {
+        uint64_t a = splitmix64(x), b = splitmix64(x);
+        state[0][lane] = static_cast<uint32_t>(a);
+        state[1][lane] = static_cast<uint32_t>(a >> 32);
+        state[2][lane] = static_cast<uint32_t>(b);
+        state[3][lane] = static_cast<uint32_t>(b >> 32);
+        // xoshiro never leaves the all zero state.
+        if (!(state[0][lane] | state[1][lane] | state[2][lane] | state[3][lane]))
+            state[0][lane] = 1;
+    }
+    buffered = BUFFER_SIZE;
+}
+
+// top 24 bits of a xoshiro128+ result (the low bits are weak) scaled into [0, 1).
+static constexpr float TO_UNIT = 1.0f / 16777216.0f;
+
+void random_stream::step(float* out) {
+#ifdef LOXOC_RANDOM_SSE
+    __m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i*>(state[0]));
+    __m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i*>(state[1]));
+    __m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i*>(state[2]));
+    __m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i*>(state[3]));
+    __m128i result = _mm_add_epi32(s0, s3);
+    __m128i t = _mm_slli_epi32(s1, 9);
+    s2 = _mm_xor_si128(s2, s0);
+    s3 = _mm_xor_si128(s3, s1);
+    s1 = _mm_xor_si128(s1, s2);
+    s0 = _mm_xor_si128(s0, s3);
+    s2 = _mm_xor_si128(s2, t);
+    s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+    _mm_store_si128(reinterpret_cast<__m128i*>(state[0]), s0);
+    _mm_store_si128(reinterpret_cast<__m128i*>(state[1]), s1);
+    _mm_store_si128(reinterpret_cast<__m128i*>(state[2]), s2);
+    _mm_store_si128(reinterpret_cast<__m128i*>(state[3]), s3);
+    // the shifted values fit in 24 bits, so the signed conversion is exact.
+    __m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), _mm_set1_ps(TO_UNIT));
+    _mm_storeu_ps(out, unit);
+#else
+    for (size_t lane = 0; lane < LANES; lane++) {
+        uint32_t& s0 = state[0][lane];
+        uint32_t& s1 = state[1][lane];
+        uint32_t& s2 = state[2][lane];
+        uint32_t& s3 = state[3][lane];
+        uint32_t result = s0 + s3;
+        uint32_t t = s1 << 9;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = (s3 << 11) | (s3 >> 21);
+        out[lane] = (result >> 8) * TO_UNIT;
+    }
+#endif
+}
+
+void random_stream::fill(float* out, size_t count) {
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES)
+        step(out + i);
+    if (i < count) {
+        float rest[LANES];
+        step(rest);
+        std::memcpy(out + i, rest, (count - i) * sizeof(float));
+    }
+}
+
+void random_stream::fill_range(float* out, size_t count, float low, float high) {
+    fill(out, count);
+    float diff = high - low;
+    for (size_t i = 0; i < count; i++)
+        out[i] = low + out[i] * diff;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// Seedable random numbers for effects that need to replay exactly, like particle emitters.
+// Four xoshiro128+ generators run side by side, one per sse lane, so fill() produces 4 values per step.
+// The scalar fallback steps the same four lanes, so a seed gives the same sequence with or without sse.
+// Not thread safe, give each user its own stream.
+
+class random_stream {
+public:
+    random_stream(uint64_t seed = 1) {
+        set_seed(seed);
+    }
+
+    // restarts the sequence.  Every seed, including 0, gives a usable stream.
+    void set_seed(uint64_t seed);
+    inline uint64_t get_seed() const {
+        return seed;
+    }
+
+    // fills out with count floats in [0, 1).
+    void fill(float* out, size_t count);
+    // fills out with count floats in [low, high).
+    void fill_range(float* out, size_t count, float low, float high);
+
+    // one float in [0, 1), served from a small buffer that's refilled with fill().
+    inline float next() {
+        if (buffered == BUFFER_SIZE) {
+            fill(buffer, BUFFER_SIZE);
+            buffered = 0;
+        }
+        return buffer[buffered++];
+    }
+
+    inline float range(float low, float high) {
+        return low + next() * (high - low);
+    }
+
+    static constexpr size_t LANES = 4;
+private:
+    // advances every lane once and writes one float per lane.
+    void step(float* out);
+
+    uint64_t seed = 1;
+    alignas(16) uint32_t state[4][LANES]; // state[word][lane]
+
+    static constexpr size_t BUFFER_SIZE = 64;
+    alignas(16) float buffer[BUFFER_SIZE];
+    size_t buffered = BUFFER_SIZE;
+};
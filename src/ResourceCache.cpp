@@ -0,0 +1,271 @@
+#include "ResourceCache.h"
+#include "ThreadPool.h"
+#include <set>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+bool resource_cache::enabled = true;
+bool resource_cache::parallel_decode = true;
+std::recursive_mutex resource_cache::lock;
+resource_stats resource_cache::stats;
+map<string, string> resource_cache::shader_sources;
+map<uint64_t, rc_shader> resource_cache::shaders;
+map<uint64_t, GLuint> resource_cache::programs;
+map<string, rc_texture> resource_cache::textures;
+
+string resource_cache::get_shader_source(const string& file_path) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    if (enabled) {
+        auto found = shader_sources.find(file_path);
+        if (found != shader_sources.end())
+            return found->second;
+    }
+
+    std::ifstream file_stream(file_path);
+    if (!file_stream.is_open()) {
+        throw std::runtime_error("Could not open file: " + file_path);
+    }
+    std::stringstream buffer;
+    buffer << file_stream.rdbuf() << std::endl;
+    stats.shader_file_reads++;
+    if (enabled)
+        shader_sources[file_path] = buffer.str();
+    return buffer.str();
+}
+
+rc_shader resource_cache::get_shader(const string& file_path, ShaderType type, bool defer_compile) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    string source = get_shader_source(file_path);
+    if (!enabled) {
+        stats.shader_misses++;
+        return new RC(new shader(source, type, defer_compile));
+    }
+
+    uint64_t key = content_hash(source, static_cast<uint64_t>(type) + 1);
+    auto found = shaders.find(key);
+    if (found != shaders.end()) {
+        stats.shader_hits++;
+        found->second->inc();
+        return found->second;
+    }
+    stats.shader_misses++;
+    auto ret = new RC(new shader(source, type, defer_compile));
+    shaders[key] = ret;
+    ret->inc(); // one for the cache, one for the caller
+    return ret;
+}
+
+rc_texture resource_cache::get_texture(const string& file_path, TextureWraping wrap, TextureFiltering filtering, bool defer_upload) {
+    string key = texture_key(file_path, wrap, filtering);
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        if (enabled) {
+            auto found = textures.find(key);
+            if (found != textures.end()) {
+                stats.texture_hits++;
+                // a hit from the gl thread may find a texture that a background load has not uploaded yet.
+                if (!defer_upload)
+                    found->second->data->upload();
+                found->second->inc();
+                return found->second;
+            }
+        }
+    }
+
+    // decode without holding the lock like prefetch_textures, the upload waits untill the handle is settled.
+    texture* decoded = new texture(file_path, wrap, filtering, true);
+
+    rc_texture ret;
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        stats.texture_decodes++;
+        if (!enabled) {
+            ret = new RC(decoded);
+        } else {
+            auto found = textures.find(key);
+            if (found != textures.end()) {
+                // another thread cached the same file while we were decoding.
+                delete decoded;
+                ret = found->second;
+            } else {
+                ret = new RC(decoded);
+                textures[key] = ret;
+                stats.textures = textures.size();
+            }
+            ret->inc(); // one for the cache, one for the caller
+        }
+    }
+    // only the gl thread uploads, and the reference taken above keeps purge_unused away from the handle.
+    if (!defer_upload)
+        ret->data->upload();
+    return ret;
+}
+
+vector<rc_texture> resource_cache::prefetch_textures(const vector<string>& file_paths, TextureWraping wrap, TextureFiltering filtering) {
+    vector<rc_texture> ret;
+    vector<string> misses;
+    {
+        std::lock_guard<std::recursive_mutex> guard(lock);
+        std::set<string> seen;
+        for (const string& file_path : file_paths) {
+            if (!seen.insert(file_path).second)
+                continue;
+            if (enabled) {
+                auto found = textures.find(texture_key(file_path, wrap, filtering));
+                if (found != textures.end()) {
+                    stats.texture_hits++;
+                    found->second->inc();
+                    ret.push_back(found->second);
+                    continue;
+                }
+            }
+            misses.push_back(file_path);
+        }
+    }
+
+    // decode without holding the lock, stb_image keeps its error state per thread.
+    auto decode_start = std::chrono::steady_clock::now();
+    vector<texture*> decoded(misses.size(), nullptr);
+    auto decode = [&](size_t i) {
+        try {
+            decoded[i] = new texture(misses[i], wrap, filtering, true);
+        } catch (std::runtime_error&) {}
+    };
+    if (parallel_decode)
+        thread_pool::get_global()->parallel_for(misses.size(), decode);
+    else
+        for (size_t i = 0; i < misses.size(); i++)
+            decode(i);
+    double decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decode_start).count();
+
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    stats.last_texture_decode_ms = decode_ms;
+    for (size_t i = 0; i < misses.size(); i++) {
+        if (!decoded[i])
+            continue;
+        stats.texture_decodes++;
+        if (!enabled) {
+            ret.push_back(new RC(decoded[i]));
+            continue;
+        }
+        string key = texture_key(misses[i], wrap, filtering);
+        auto found = textures.find(key);
+        if (found != textures.end()) {
+            // another import cached the same file while we were decoding.
+            delete decoded[i];
+            found->second->inc();
+            ret.push_back(found->second);
+            continue;
+        }
+        auto handle = new RC(decoded[i]);
+        textures[key] = handle;
+        handle->inc();
+        ret.push_back(handle);
+    }
+    stats.textures = textures.size();
+    return ret;
+}
+
+string resource_cache::texture_key(const string& file_path, TextureWraping wrap, TextureFiltering filtering) {
+    std::stringstream key_ss;
+    key_ss << file_path << '|' << static_cast<int>(wrap) << '|' << static_cast<int>(filtering);
+    return key_ss.str();
+}
+
+uint64_t resource_cache::program_key(rc_shader vertex, rc_shader fragment, rc_shader geometry, rc_shader compute) {
+    uint64_t key = 0;
+    for (rc_shader stage : {vertex, fragment, geometry, compute})
+        key = hash_combine(key, stage ? hash_combine(stage->data->source_hash, static_cast<uint64_t>(stage->data->type)) : 0);
+    return key;
+}
+
+GLuint resource_cache::find_program(uint64_t key) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    if (!enabled)
+        return 0;
+    auto found = programs.find(key);
+    if (found == programs.end())
+        return 0;
+    stats.program_hits++;
+    return found->second;
+}
+
+void resource_cache::store_program(uint64_t key, GLuint program, bool linked) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    if (linked)
+        stats.program_links++;
+    else
+        stats.program_binary_loads++;
+    if (!enabled)
+        return;
+    programs[key] = program;
+    stats.programs = programs.size();
+}
+
+size_t resource_cache::purge_unused() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    size_t purged = 0;
+    for (auto it = shaders.begin(); it != shaders.end();) {
+        if (it->second->refcount == 1) {
+            RC_collect(it->second);
+            it = shaders.erase(it);
+            purged++;
+        } else
+            it++;
+    }
+    for (auto it = textures.begin(); it != textures.end();) {
+        if (it->second->refcount == 1) {
+            glDeleteTextures(1, &it->second->data->gl_texture);
+            RC_collect(it->second);
+            it = textures.erase(it);
+            purged++;
+        } else
+            it++;
+    }
+    stats.textures = textures.size();
+    return purged;
+}
+
+void resource_cache::clear() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    for (auto& [key, shdr] : shaders)
+        RC_collect(shdr);
+    clear_textures();
+    shader_sources.clear();
+    shaders.clear();
+    programs.clear();
+    stats.programs = 0;
+}
+
+void resource_cache::clear_textures() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    for (auto& [key, tex] : textures)
+        RC_collect(tex);
+    textures.clear();
+    stats.textures = 0;
+}
+
+resource_stats resource_cache::get_stats() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    return stats;
+}
+
+void resource_cache::reset_stats() {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    size_t programs_count = stats.programs, textures_count = stats.textures;
+    stats = resource_stats();
+    stats.programs = programs_count;
+    stats.textures = textures_count;
+}
+
+void resource_cache::add_texture_bytes(size_t bytes) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    stats.texture_bytes += bytes;
+}
+
+void resource_cache::set_last_import_ms(double ms) {
+    std::lock_guard<std::recursive_mutex> guard(lock);
+    stats.last_import_ms = ms;
+}
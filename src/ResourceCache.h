@@ -0,0 +1,103 @@
+#pragma once
+#include <string>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include "glad/gl.h"
+#include "RC.h"
+#include "Shader.h"
+#include "Texture.h"
+
+using std::string;
+using std::map;
+using std::vector;
+
+typedef RC<texture*>* rc_texture;
+typedef RC<shader*>* rc_shader;
+
+// 64 bit FNV-1a, used to address shader sources and programs by their content.
+inline uint64_t content_hash(const char* data, size_t size, uint64_t seed = 14695981039346656037ull) {
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline uint64_t content_hash(const string& data, uint64_t seed = 14695981039346656037ull) {
+    return content_hash(data.data(), data.size(), seed);
+}
+
+inline uint64_t hash_combine(uint64_t a, uint64_t b) {
+    return a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2));
+}
+
+struct resource_stats {
+    size_t shader_file_reads = 0;
+    size_t shader_hits = 0, shader_misses = 0;
+    size_t program_hits = 0, program_links = 0;
+    // programs created from binaries on disk instead of being linked.
+    size_t program_binary_loads = 0;
+    size_t texture_hits = 0, texture_decodes = 0;
+    // estimated bytes of texture memory uploaded, including mip chains.
+    size_t texture_bytes = 0;
+    size_t programs = 0, textures = 0;
+    // wall time of the last mesh::import_into call.
+    double last_import_ms = 0.0;
+    // wall time spent decoding images in the last prefetch_textures call.
+    double last_texture_decode_ms = 0.0;
+};
+
+// Deduplicates shader sources, linked programs and textures across every material in the engine.
+// Shaders and textures are handed out as RC handles with a reference already taken for the caller.
+// The cache keeps one reference of its own so entries survive untill purge_unused() or clear().
+// Linked programs are keyed by the content hashes of their stages and live as long as the cache.
+
+class resource_cache {
+public:
+    // When disabled every request creates a fresh resource, as the engine did before the cache existed.
+    static bool enabled;
+    static inline void set_enabled(bool value) { enabled = value; }
+    static inline bool is_enabled() { return enabled; }
+
+    static rc_shader get_shader(const string& file_path, ShaderType type, bool defer_compile = false);
+    static string get_shader_source(const string& file_path);
+
+    static rc_texture get_texture(const string& file_path, TextureWraping wrap, TextureFiltering filtering, bool defer_upload = false);
+    // Decodes every texture in file_paths that is not cached yet, concurrently on the global thread_pool when
+    // parallel_decode is set, and adds them to the cache without uploading them.  Returns a handle (with a reference
+    // taken for the caller) for each texture that could be loaded so the caller can upload them in one batch.
+    // Files that fail to decode are skipped, the error surfaces again when get_texture is called for them.
+    static vector<rc_texture> prefetch_textures(const vector<string>& file_paths, TextureWraping wrap, TextureFiltering filtering);
+    static bool parallel_decode;
+    static inline void set_parallel_decode(bool value) { parallel_decode = value; }
+    static inline bool is_parallel_decode() { return parallel_decode; }
+
+    static uint64_t program_key(rc_shader vertex, rc_shader fragment, rc_shader geometry, rc_shader compute);
+    // returns 0 when no program is cached for the key.
+    static GLuint find_program(uint64_t key);
+    // linked is false for programs restored from the program_binary_cache.
+    static void store_program(uint64_t key, GLuint program, bool linked = true);
+
+    // Releases cached shaders and textures that are no longer referenced outside the cache.
+    static size_t purge_unused();
+    // Forgets every cache entry.  Programs are not deleted since materials may still be using them.
+    static void clear();
+    // Forgets only the cached textures, so the next import decodes its images again.  Textures still in use stay alive.
+    static void clear_textures();
+
+    static resource_stats get_stats();
+    static void reset_stats();
+    static void add_texture_bytes(size_t bytes);
+    static void set_last_import_ms(double ms);
+private:
+    static std::recursive_mutex lock;
+    static resource_stats stats;
+    static map<string, string> shader_sources;
+    static map<uint64_t, rc_shader> shaders;
+    static map<uint64_t, GLuint> programs;
+    static map<string, rc_texture> textures;
+    static string texture_key(const string& file_path, TextureWraping wrap, TextureFiltering filtering);
+};
@@ -1,12 +1,14 @@
 #include "Shader.h"
+#include "ResourceCache.h"
 #include <fstream>
 #include <sstream>
 
-shader::shader(string source, ShaderType type) : source(source), type(type) {
-    this->compile();
+shader::shader(string source, ShaderType type, bool defer_compile) : source(source), type(type), source_hash(content_hash(source)) {
+    if (!defer_compile)
+        this->compile();
 }
 
-shader* shader::from_file(string filepath, ShaderType type) {
+shader* shader::from_file(string filepath, ShaderType type, bool defer_compile) {
     std::ifstream fileStream(filepath);
     if (!fileStream.is_open()) {
         throw std::runtime_error("Could not open file: " + filepath);
@@ -15,7 +17,7 @@ shader* shader::from_file(string filepath, ShaderType type) {
     std::stringstream buffer;
     buffer << fileStream.rdbuf() << std::endl;
     fileStream.close();
-    return new shader(buffer.str(), type);
+    return new shader(buffer.str(), type, defer_compile);
 }
 
 void shader::compile() {
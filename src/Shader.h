@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <iostream>
+#include <cstdint>
 #include "glad/gl.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_opengl.h>
@@ -39,11 +40,14 @@ class shader {
 public:
     // do not use empty constructor, only exists for python interop.  Will add throws later.
     shader(){};
-    shader(string source, ShaderType type);
-    static shader* from_file(string filepath, ShaderType type);
+    // when defer_compile is set nothing touches gl untill compile() is called, so it can be built off the gl thread.
+    shader(string source, ShaderType type, bool defer_compile = false);
+    static shader* from_file(string filepath, ShaderType type, bool defer_compile = false);
     void compile();
     string source;
     ShaderType type;
     GLuint shader_handle;
+    // content hash of source, used to share linked programs. (see ResourceCache.h)
+    uint64_t source_hash = 0;
 };
 
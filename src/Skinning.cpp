@@ -0,0 +1,194 @@
+#include "Skinning.h"
+#include "Animation.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <tuple>
+#include <string>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define LOXOC_SKINNING_SSE
+#include <xmmintrin.h>
+#endif
+
+// vertices per parallel block, small enough to balance, large enough to hide the hand off.
+#define SKINNING_BLOCK 2048
+
+void skin_vertices_scalar(const vertex* vertices, size_t count, const glm::mat4* palette, size_t bone_count, glm::vec3* positions, glm::vec3* normals) {
+    for (size_t v = 0; v < count; v++) {
+        const vertex& vert = vertices[v];
+        glm::vec4 total_position(0.0f);
+        glm::vec3 total_normal(0.0f);
+        float total_weight = 0.0f;
+        bool bind_pose = false;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+            int id = vert.bone_ids[i];
+            if (id == -1)
+                continue;
+            if (id < 0 || static_cast<size_t>(id) >= bone_count) {
+                bind_pose = true;
+                break;
+            }
+            const glm::mat4& bone = palette[id];
+            total_position += bone * glm::vec4(vert.position, 1.0f) * vert.weights[i];
+            total_normal += glm::mat3(bone) * vert.normal * vert.weights[i];
+            total_weight += vert.weights[i];
+        }
+        // vertices without bone influences, like props parented to the rig, stay where they were modeled.
+        if (bind_pose || total_weight == 0.0f) {
+            total_position = glm::vec4(vert.position, 1.0f);
+            total_normal = vert.normal;
+        }
+        positions[v] = glm::vec3(total_position);
+        if (normals)
+            normals[v] = total_normal;
+    }
+}
+
+void skin_vertices(const vertex* vertices, size_t count, const glm::mat4* palette, size_t bone_count, glm::vec3* positions, glm::vec3* normals) {
+#ifdef LOXOC_SKINNING_SSE
+    alignas(16) float out[4];
+    for (size_t v = 0; v < count; v++) {
+        const vertex& vert = vertices[v];
+        __m128 col0 = _mm_setzero_ps(), col1 = _mm_setzero_ps(), col2 = _mm_setzero_ps(), col3 = _mm_setzero_ps();
+        bool bind_pose = false;
+        float total_weight = 0.0f;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+            int id = vert.bone_ids[i];
+            if (id == -1)
+                continue;
+            if (id < 0 || static_cast<size_t>(id) >= bone_count) {
+                bind_pose = true;
+                break;
+            }
+            total_weight += vert.weights[i];
+            const float* bone = &palette[id][0][0];
+            __m128 weight = _mm_set1_ps(vert.weights[i]);
+            col0 = _mm_add_ps(col0, _mm_mul_ps(weight, _mm_loadu_ps(bone)));
+            col1 = _mm_add_ps(col1, _mm_mul_ps(weight, _mm_loadu_ps(bone + 4)));
+            col2 = _mm_add_ps(col2, _mm_mul_ps(weight, _mm_loadu_ps(bone + 8)));
+            col3 = _mm_add_ps(col3, _mm_mul_ps(weight, _mm_loadu_ps(bone + 12)));
+        }
+        if (bind_pose || total_weight == 0.0f) {
+            positions[v] = vert.position;
+            if (normals)
+                normals[v] = vert.normal;
+            continue;
+        }
+        // rotation part shared by the position and normal, the position adds the translation column.
+        __m128 rotated = _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(col0, _mm_set1_ps(vert.position.x)),
+            _mm_mul_ps(col1, _mm_set1_ps(vert.position.y))),
+            _mm_mul_ps(col2, _mm_set1_ps(vert.position.z)));
+        _mm_store_ps(out, _mm_add_ps(rotated, col3));
+        positions[v] = glm::vec3(out[0], out[1], out[2]);
+        if (normals) {
+            __m128 normal = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(col0, _mm_set1_ps(vert.normal.x)),
+                _mm_mul_ps(col1, _mm_set1_ps(vert.normal.y))),
+                _mm_mul_ps(col2, _mm_set1_ps(vert.normal.z)));
+            _mm_store_ps(out, normal);
+            normals[v] = glm::vec3(out[0], out[1], out[2]);
+        }
+    }
+#else
+    skin_vertices_scalar(vertices, count, palette, bone_count, positions, normals);
+#endif
+}
+
+void skin_vertices_parallel(const vertex* vertices, size_t count, const glm::mat4* palette, size_t bone_count, glm::vec3* positions, glm::vec3* normals, thread_pool* pool) {
+    if (!pool || pool->size() == 0 || count <= SKINNING_BLOCK) {
+        skin_vertices(vertices, count, palette, bone_count, positions, normals);
+        return;
+    }
+    size_t blocks = (count + SKINNING_BLOCK - 1) / SKINNING_BLOCK;
+    pool->parallel_for(blocks, [&](size_t b) {
+        size_t begin = b * SKINNING_BLOCK;
+        size_t end = std::min(count, begin + SKINNING_BLOCK);
+        skin_vertices(vertices + begin, end - begin, palette, bone_count, positions + begin, normals ? normals + begin : nullptr);
+    });
+}
+
+vertex_animation_texture::vertex_animation_texture(const mesh& m, animation* anim, float fps) : fps(fps) {
+    if (!m.vertices || !anim || fps <= 0.0f)
+        throw std::runtime_error("Can't bake an animation without vertices, an animation and a positive frame rate.");
+
+    // assimp leaves ticks per second at 0 when the file doesn't say, 25 is its documented default.
+    float ticks_per_second = anim->ticks_per_second > 0.0f ? anim->ticks_per_second : 25.0f;
+    duration = anim->duration / ticks_per_second;
+    frame_count = static_cast<int>(std::ceil(duration * fps)) + 1;
+    vertex_count = m.vertices->size();
+    width = static_cast<int>(std::min<size_t>(std::max<size_t>(vertex_count, 1), MAX_WIDTH));
+    rows_per_frame = static_cast<int>((vertex_count + width - 1) / width);
+
+    size_t frame_texels = static_cast<size_t>(width) * rows_per_frame;
+    positions.assign(frame_texels * frame_count, glm::vec4(0.0f));
+    normals.assign(frame_texels * frame_count, glm::vec4(0.0f));
+
+    animator player(anim);
+    vector<glm::vec3> skinned_positions(vertex_count), skinned_normals(vertex_count);
+    for (int f = 0; f < frame_count; f++) {
+        player.current_time = std::min(f / fps * ticks_per_second, anim->duration);
+        player.calculate_bone_transforms();
+        skin_vertices_parallel(m.vertices->data(), vertex_count, player.final_bone_matricies.data(), player.final_bone_matricies.size(),
+            skinned_positions.data(), skinned_normals.data(), thread_pool::get_global());
+        size_t base = frame_texels * f;
+        for (size_t v = 0; v < vertex_count; v++) {
+            positions[base + v] = glm::vec4(skinned_positions[v], 1.0f);
+            normals[base + v] = glm::vec4(skinned_normals[v], 0.0f);
+        }
+    }
+}
+
+vertex_animation_texture::~vertex_animation_texture() {
+    if (position_texture)
+        glDeleteTextures(1, &position_texture);
+    if (normal_texture)
+        glDeleteTextures(1, &normal_texture);
+}
+
+void vertex_animation_texture::upload() {
+    if (position_texture || positions.empty())
+        return;
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    int height = rows_per_frame * frame_count;
+    if (height > max_size)
+        throw std::runtime_error("Baked animation needs " + std::to_string(height) + " texture rows but the gpu allows " + std::to_string(max_size) + ", use a lower frame rate.");
+
+    for (auto [tex, data, format] : {
+        std::tuple{&position_texture, &positions, GL_RGBA32F},
+        std::tuple{&normal_texture, &normals, GL_RGBA16F}
+    }) {
+        glGenTextures(1, tex);
+        glBindTexture(GL_TEXTURE_2D, *tex);
+        // fetched with texelFetch, no filtering or mips.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, GL_RGBA, GL_FLOAT, data->data());
+        data->clear();
+        data->shrink_to_fit();
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void vertex_animation_texture::set_uniforms(rc_material mater, float time) {
+    glActiveTexture(GL_TEX_N_ITTER[POSITION_UNIT]);
+    glBindTexture(GL_TEXTURE_2D, position_texture);
+    glActiveTexture(GL_TEX_N_ITTER[NORMAL_UNIT]);
+    glBindTexture(GL_TEXTURE_2D, normal_texture);
+    // the material's maps are bound to unit 0 onwards and expect it to be active.
+    glActiveTexture(GL_TEX_N_ITTER[0]);
+    mater->data->set_uniform("baked_positions", POSITION_UNIT);
+    mater->data->set_uniform("baked_normals", NORMAL_UNIT);
+    mater->data->set_uniform("baked_width", width);
+    mater->data->set_uniform("baked_rows_per_frame", rows_per_frame);
+    mater->data->set_uniform("baked_frame_count", frame_count);
+    mater->data->set_uniform("baked_fps", fps);
+    float clip_time = duration > 0.0f ? std::fmod(time, duration) : 0.0f;
+    if (clip_time < 0.0f)
+        clip_time += duration;
+    mater->data->set_uniform("baked_time", clip_time);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "glad/gl.h"
+#include <glm/glm.hpp>
+#include "Mesh.h"
+#include "Material.h"
+
+using std::vector;
+
+class animation;
+class thread_pool;
+
+// Skins count vertices on the cpu with the bone palette, the same way default_vertex_animated.glsl does.
+// Bone ids past bone_count, and vertices without any weighted bone, leave the vertex in its bind pose.  normals may be null.
+// Uses sse when the compiler targets it: the (up to 4) influencing bone matrices are blended a column per register
+// and the vertex is transformed once, instead of transforming it by every bone.
+void skin_vertices(const vertex* vertices, size_t count, const glm::mat4* palette, size_t bone_count, glm::vec3* positions, glm::vec3* normals);
+// plain scalar version of skin_vertices, the reference the sse path is checked against.
+void skin_vertices_scalar(const vertex* vertices, size_t count, const glm::mat4* palette, size_t bone_count, glm::vec3* positions, glm::vec3* normals);
+// skin_vertices split into blocks across pool, for large meshes and many objects on headless servers.
+void skin_vertices_parallel(const vertex* vertices, size_t count, const glm::mat4* palette, size_t bone_count, glm::vec3* positions, glm::vec3* normals, thread_pool* pool);
+
+// One animation baked into textures for a single mesh: the skinned position and normal of every vertex at a
+// fixed frame rate.  default_vertex_baked.glsl plays it back with gl_VertexID and a time, so an instance costs
+// two texture fetches per vertex instead of a pose evaluation.
+// A frame takes rows_per_frame rows of width texels, vertex i of frame f is at (i % width, f * rows_per_frame + i / width).
+class vertex_animation_texture {
+public:
+    vertex_animation_texture(){}
+    // samples anim at fps and skins m with the results.  Cpu only, call upload() on the gl thread afterwards.
+    vertex_animation_texture(const mesh& m, animation* anim, float fps);
+    ~vertex_animation_texture();
+
+    // creates the textures and frees the cpu copy.  Must be called on the gl thread.
+    void upload();
+    // binds the textures and sets the playback uniforms of mater for a clip time in seconds.
+    void set_uniforms(rc_material mater, float time);
+
+    int width = 0, rows_per_frame = 0, frame_count = 0;
+    size_t vertex_count = 0;
+    float fps = 30.0f;
+    // clip length in seconds.
+    float duration = 0.0f;
+    GLuint position_texture = 0, normal_texture = 0;
+
+    // texture units the baked textures are bound to, after the bone palette.
+    static constexpr int POSITION_UNIT = 4, NORMAL_UNIT = 5;
+    static constexpr int MAX_WIDTH = 4096;
+private:
+    vector<glm::vec4> positions, normals;
+};
@@ -0,0 +1,152 @@
+#include "StreamBuffer.h"
+#include <algorithm>
+#include <stdexcept>
+
+bool stream_buffer::allow_persistent = true;
+
+stream_buffer* stream_buffer::get_global() {
+    // never freed, the gl context is gone by the time static destructors would run.
+    static stream_buffer* global = new stream_buffer();
+    return global;
+}
+
+stream_buffer::~stream_buffer() {
+    destroy();
+}
+
+void stream_buffer::create(size_t capacity) {
+    frame_capacity = capacity;
+    size_t total = frame_capacity * FRAMES;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    generation++;
+    persistent = allow_persistent && GLAD_GL_ARB_buffer_storage && glBufferStorage;
+    if (persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, total, nullptr, flags);
+        mapped = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, total, flags));
+        if (!mapped) {
+            // some drivers expose the extension but refuse the mapping, buffer storage is immutable so start over.
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            persistent = false;
+        }
+    }
+    if (!persistent)
+        glBufferData(GL_ARRAY_BUFFER, total, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    frame = 0;
+    head = 0;
+    stats.frame_capacity = frame_capacity;
+    stats.persistent = persistent;
+}
+
+void stream_buffer::retire() {
+    for (GLsync& fence : fences) {
+        if (fence)
+            glDeleteSync(fence);
+        fence = 0;
+    }
+    if (buffer)
+        retired.push_back({buffer, mapped != nullptr});
+    buffer = 0;
+    mapped = nullptr;
+}
+
+void stream_buffer::release_retired() {
+    for (const retired_buffer& old : retired) {
+        if (old.mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, old.buffer);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        // draws already issued from it keep it alive untill they finish.
+        glDeleteBuffers(1, &old.buffer);
+    }
+    retired.clear();
+}
+
+void stream_buffer::destroy() {
+    retire();
+    release_retired();
+}
+
+stream_range stream_buffer::allocate(size_t size, size_t alignment) {
+    alignment = std::max<size_t>(alignment, 1);
+    auto align = [alignment](size_t offset) {
+        return (offset + alignment - 1) / alignment * alignment;
+    };
+    if (!buffer)
+        create(frame_capacity);
+    // offsets are aligned from the start of the buffer, the region's base isn't a multiple of every alignment.
+    size_t base = frame * frame_capacity;
+    size_t start = align(base + head) - base;
+    if (start + size > frame_capacity) {
+        // ranges already handed out this frame keep pointing into the old buffer, it stays mapped and alive untill
+        // end_frame().  The rest of the frame goes to the new one.
+        retire();
+        create(std::max(frame_capacity * 2, size));
+        stats.grows++;
+        base = 0;
+        start = 0;
+    }
+    head = start + size;
+
+    stream_range ret;
+    ret.buffer = buffer;
+    ret.generation = generation;
+    ret.offset = base + start;
+    ret.size = size;
+    if (size == 0)
+        return ret;
+    if (persistent) {
+        ret.data = mapped + ret.offset;
+    } else {
+        // this frame's region isn't in use by the gpu (end_frame waited for it), so there's nothing to sync with.
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        ret.data = glMapBufferRange(GL_ARRAY_BUFFER, ret.offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        if (!ret.data)
+            throw std::runtime_error("Failed to map the streaming vertex buffer.");
+    }
+    return ret;
+}
+
+void stream_buffer::commit(const stream_range& range) {
+    if (persistent || !range.data || range.generation != generation)
+        return;
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void stream_buffer::end_frame() {
+    // every draw from the replaced buffers has been issued by now.
+    release_retired();
+    if (!buffer)
+        return;
+    stats.frame_bytes = head;
+    stats.peak_frame_bytes = std::max(stats.peak_frame_bytes, head);
+
+    if (fences[frame])
+        glDeleteSync(fences[frame]);
+    fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame = (frame + 1) % FRAMES;
+    head = 0;
+
+    GLsync& fence = fences[frame];
+    if (!fence)
+        return;
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        stats.stalls++;
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1ms
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = 0;
+}
+
+stream_buffer_stats stream_buffer::get_stats() const {
+    return stats;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "glad/gl.h"
+
+// One sub-allocation of a stream_buffer, valid for the frame it was made in.
+struct stream_range {
+    GLuint buffer = 0;
+    // changes whenever the ring's buffer is replaced.  Compare it rather than buffer to know when attribute
+    // pointers need to be set again, gl reuses the names of deleted buffers.
+    size_t generation = 0;
+    // byte offset of the range in buffer, what attribute pointers and draw calls use.
+    size_t offset = 0;
+    size_t size = 0;
+    // where to write the data, untill commit() is called.
+    void* data = nullptr;
+};
+
+struct stream_buffer_stats {
+    // bytes handed out in the last finished frame, and the most handed out in any frame.
+    size_t frame_bytes = 0;
+    size_t peak_frame_bytes = 0;
+    // bytes each of the three frame regions can hold.
+    size_t frame_capacity = 0;
+    // frames that had to wait for the gpu to finish with their region.
+    size_t stalls = 0;
+    // times the buffer was reallocated to fit a frame.
+    size_t grows = 0;
+    bool persistent = false;
+};
+
+// Ring buffer for vertex data that is rewritten every frame (particle instances, debug lines).
+// The buffer is split into one region per frame in flight.  Writers sub-allocate from the current frame's region
+// and write straight into mapped memory, end_frame() fences the region and moves on to the next one, only waiting
+// if the gpu is still reading it from three frames ago.
+// The buffer is persistently mapped when GL_ARB_buffer_storage is available, otherwise each range is mapped
+// unsynchronized, which every GL 3.0+ driver (Mesa's software ones included) supports.
+// Must only be used on the thread that owns the GL context.
+
+class stream_buffer {
+public:
+    stream_buffer(size_t frame_capacity = DEFAULT_FRAME_CAPACITY) : frame_capacity(frame_capacity) {}
+    ~stream_buffer();
+
+    stream_buffer(const stream_buffer&) = delete;
+    stream_buffer& operator=(const stream_buffer&) = delete;
+
+    // size bytes with an offset that is a multiple of alignment (any value, not just powers of two, so an offset
+    // can land on a whole vertex and be drawn with glDrawArrays' first).  A frame that outgrows its region
+    // reallocates the buffer, so read buffer from each range instead of keeping it.  (see stream_range::generation)
+    // Ranges handed out earlier in the frame stay valid untill end_frame(), the old buffer is only released there.
+    stream_range allocate(size_t size, size_t alignment = 16);
+    // finishes writing range.  Call it before drawing from the range and before the next allocate().
+    void commit(const stream_range& range);
+    // fences the current frame's draws and moves to the next region.  Called by the window after each swap.
+    void end_frame();
+
+    stream_buffer_stats get_stats() const;
+
+    // when false, the unsynchronized path is used even if persistent mapping is available.  Only read when the
+    // gl buffer is created.
+    static bool allow_persistent;
+    static inline void set_allow_persistent(bool value) {
+        allow_persistent = value;
+    }
+
+    // The buffer shared by the engine's renderers.  The gl buffer is created by the first allocate().
+    static stream_buffer* get_global();
+
+    static constexpr size_t FRAMES = 3;
+    static constexpr size_t DEFAULT_FRAME_CAPACITY = 4 << 20;
+private:
+    void create(size_t capacity);
+    // moves the buffer to retired, ranges from it may not have been drawn yet.
+    void retire();
+    void release_retired();
+    void destroy();
+
+    GLuint buffer = 0;
+    size_t generation = 0;
+    char* mapped = nullptr;
+    bool persistent = false;
+    size_t frame_capacity;
+    size_t frame = 0;
+    size_t head = 0; // bytes used in the current frame's region
+    GLsync fences[FRAMES] = {};
+
+    struct retired_buffer {
+        GLuint buffer;
+        bool mapped;
+    };
+    // buffers replaced by a grow this frame, unmapped and deleted by end_frame().
+    std::vector<retired_buffer> retired;
+
+    stream_buffer_stats stats;
+};
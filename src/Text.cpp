@@ -1,4 +1,8 @@
 #include "Text.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <functional>
 
 // FONT
 
@@ -28,109 +32,301 @@ font::font(const string& font_path, int font_size) {
 }
 
 void font::init_font(FT_Face& face) {
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
-    
+    // the glyphs are copied out of freetype first, packing needs all their sizes before anything is placed.
+    vector<unsigned char> bitmaps[128];
     for (unsigned char c = 0; c < 128; c++)
     {
+        font_chars[c] = character{glm::vec4(0.0f), glm::ivec2(0), glm::ivec2(0), 0};
         // load character glyph 
         if (FT_Load_Char(face, c, FT_LOAD_RENDER))
         {
             std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
             continue;
         }
-        // generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        bitmaps[c].resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+        for (unsigned int row = 0; row < bitmap.rows; row++)
+            std::memcpy(&bitmaps[c][row * bitmap.width], bitmap.buffer + row * bitmap.pitch, bitmap.width);
         // now store character for later use
-        character charac = {
-            texture, 
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
+        font_chars[c] = character{
+            glm::vec4(0.0f),
+            glm::ivec2(bitmap.width, bitmap.rows),
             glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
+            static_cast<GLuint>(face->glyph->advance.x)
         };
-        font_chars[c] = charac;
     }
+
+    // shelf packing, tallest glyphs first so each shelf wastes little height.  A pixel of padding around every
+    // glyph keeps linear filtering from bleeding its neighbours in.
+    const int padding = 1;
+    vector<unsigned char> order;
+    int widest = 0;
+    for (unsigned char c = 0; c < 128; c++) {
+        if (font_chars[c].size.x <= 0 || font_chars[c].size.y <= 0)
+            continue;
+        order.push_back(c);
+        widest = std::max(widest, font_chars[c].size.x + padding * 2);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](unsigned char a, unsigned char b) {
+        return font_chars[a].size.y > font_chars[b].size.y;
+    });
+
+    vector<glm::ivec2> placed(128, glm::ivec2(0));
+    int width = 64;
+    while (width < widest)
+        width *= 2;
+    int height = 0;
+    // widens the atlas untill it is no taller than it is wide.
+    for (;;) {
+        int x = 0, shelf_y = 0, shelf_height = 0;
+        for (unsigned char c : order) {
+            glm::ivec2 size = font_chars[c].size + padding * 2;
+            if (x + size.x > width) {
+                shelf_y += shelf_height;
+                x = 0;
+                shelf_height = 0;
+            }
+            placed[c] = glm::ivec2(x + padding, shelf_y + padding);
+            x += size.x;
+            shelf_height = std::max(shelf_height, size.y);
+        }
+        height = std::max(shelf_y + shelf_height, 1);
+        if (height <= width)
+            break;
+        width *= 2;
+    }
+    atlas_width = width;
+    atlas_height = height;
+
+    vector<unsigned char> pixels(static_cast<size_t>(width) * height, 0);
+    for (unsigned char c : order) {
+        character& ch = font_chars[c];
+        for (int row = 0; row < ch.size.y; row++)
+            std::memcpy(&pixels[(placed[c].y + row) * width + placed[c].x], &bitmaps[c][row * ch.size.x], ch.size.x);
+        ch.uv = glm::vec4(
+            placed[c].x / float(width), placed[c].y / float(height),
+            (placed[c].x + ch.size.x) / float(width), (placed[c].y + ch.size.y) / float(height)
+        );
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
+    glGenTextures(1, &atlas);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    // set texture options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void font::setup_buffers() {
+    // the quads are in the buffer of whichever batcher draws them, bind_vertices points the attributes at it.
     glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
     glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glEnableVertexAttribArray(1);
     glBindVertexArray(0);
 }
 
+void font::bind_vertices(GLuint buffer) {
+    if (buffer == bound_buffer)
+        return;
+    bound_buffer = buffer;
+    const GLsizei stride = TEXT_VERTEX_FLOATS * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // position and uv
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, stride, 0);
+    // color
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(4 * sizeof(float)));
+}
+
+// LAYOUT
+
+size_t text::vertex_count() const {
+    size_t quads = 0;
+    for (unsigned char c : render_text)
+        quads += c < 128 && font_data->font_chars[c].size.x > 0 && font_data->font_chars[c].size.y > 0;
+    return quads * 6;
+}
+
+size_t text::write_vertices(float* out) const {
+    // glyphs are laid out from the origin along the baseline, then scaled, rotated and moved to position.
+    const glm::vec2 origin = position->axis;
+    const glm::vec2 s = scale->axis;
+    const float cos_r = std::cos(rotation), sin_r = std::sin(rotation);
+    const glm::vec4 rgba = color->axis;
+    auto place = [&](float x, float y) {
+        x *= s.x;
+        y *= s.y;
+        return glm::vec2(origin.x + x * cos_r - y * sin_r, origin.y + x * sin_r + y * cos_r);
+    };
+
+    float* start = out;
+    float pen = 0.0f;
+    for (unsigned char c : render_text) {
+        // only ascii glyphs are loaded.
+        if (c >= 128)
+            continue;
+        const character& ch = font_data->font_chars[c];
+        if (ch.size.x > 0 && ch.size.y > 0) {
+            float left = pen + ch.bearing.x, right = left + ch.size.x;
+            float bottom = static_cast<float>(ch.bearing.y - ch.size.y), top = static_cast<float>(ch.bearing.y);
+            // the glyph's rows are stored top down, so the top of the quad takes uv.y.
+            const struct { glm::vec2 at; float u, v; } corners[6] = {
+                {place(left, top), ch.uv.x, ch.uv.y},
+                {place(left, bottom), ch.uv.x, ch.uv.w},
+                {place(right, bottom), ch.uv.z, ch.uv.w},
+
+                {place(left, top), ch.uv.x, ch.uv.y},
+                {place(right, bottom), ch.uv.z, ch.uv.w},
+                {place(right, top), ch.uv.z, ch.uv.y}
+            };
+            for (const auto& corner : corners) {
+                out[0] = corner.at.x;
+                out[1] = corner.at.y;
+                out[2] = corner.u;
+                out[3] = corner.v;
+                out[4] = rgba.r;
+                out[5] = rgba.g;
+                out[6] = rgba.b;
+                out[7] = rgba.a;
+                out += TEXT_VERTEX_FLOATS;
+            }
+        }
+        // Now advance cursors for next glyph (advance is number of 1/64 pixels)
+        pen += ch.advance >> 6;
+    }
+    return (out - start) / TEXT_VERTEX_FLOATS;
+}
+
+size_t text::next_layout_version = 0;
+
+bool text::layout_matches() const {
+    return has_layout && laid_out.font_data == font_data && laid_out.atlas == font_data->atlas && laid_out.position == position->axis
+        && laid_out.scale == scale->axis && laid_out.rotation == rotation && laid_out.color == color->axis && laid_out.render_text == render_text;
+}
+
+bool text::update_layout() {
+    if (layout_matches())
+        return false;
+    laid_out.render_text = render_text;
+    laid_out.font_data = font_data;
+    laid_out.atlas = font_data->atlas;
+    laid_out.position = position->axis;
+    laid_out.scale = scale->axis;
+    laid_out.rotation = rotation;
+    laid_out.color = color->axis;
+    has_layout = true;
+    layout_version = ++next_layout_version;
+    vertices.resize(vertex_count() * TEXT_VERTEX_FLOATS);
+    write_vertices(vertices.data());
+    return true;
+}
+
 // RENDER TEXT
 
 void text::render(camera& camera) {
-    mat->data->use_material(); // Use your shader program
+    // one batcher for every text drawn on its own, it uploads whichever text it was given last.
+    static text_batcher* single = new text_batcher(); // never freed, the gl context is gone by then
+    text* self = this;
+    single->render(&self, 1, camera);
+}
 
-    // Set uniforms like text color
-    mat->data->set_uniform("text_color", *color);
-    mat->data->set_uniform("projection", matrix4x4(glm::ortho(0.0f, (float)camera.view_width, 0.0f, (float)camera.view_height)));
-    mat->data->register_uniforms();
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(font_data->vao);
+text_stats text_batcher::stats;
 
-    
+void text_batcher::rebuild(text* const* texts, size_t count) {
+    input.assign(texts, texts + count);
+    sorted = input;
+    // groups the texts by font and material, the order within a group is kept.
+    std::stable_sort(sorted.begin(), sorted.end(), [](const text* a, const text* b) {
+        if (a->font_data != b->font_data)
+            return std::less<font*>()(a->font_data, b->font_data);
+        return std::less<material*>()(a->mat->data, b->mat->data);
+    });
 
+    sorted_keys.clear();
+    sorted_firsts.clear();
+    sorted_counts.clear();
+    sorted_versions.clear();
+    groups.clear();
+    staging.clear();
+    GLint first = 0;
+    for (text* ob : sorted) {
+        const vector<float>& vertices = ob->get_vertices();
+        GLsizei written = static_cast<GLsizei>(vertices.size() / TEXT_VERTEX_FLOATS);
+        sorted_keys.emplace_back(ob->font_data, ob->mat->data);
+        sorted_firsts.push_back(first);
+        sorted_counts.push_back(written);
+        sorted_versions.push_back(ob->layout_version);
+        staging.insert(staging.end(), vertices.begin(), vertices.end());
+        if (written == 0)
+            continue;
+        if (groups.empty() || groups.back().font_data != ob->font_data || groups.back().mat->data != ob->mat->data)
+            groups.push_back({ob->font_data, ob->mat, first, 0});
+        groups.back().count += written;
+        first += written;
+    }
 
-    auto tpos = *position;
-
-    // Iterate through all characters in the text
-    for (char c : render_text) {
-        // Get the character glyph
-        character ch = font_data->font_chars[c]; // Adjust for ASCII offset
+    if (!buffer)
+        glGenBuffers(1, &buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // a new store every time, so the draws still reading the old one don't have to finish first.
+    glBufferData(GL_ARRAY_BUFFER, staging.size() * sizeof(float), staging.data(), GL_DYNAMIC_DRAW);
+    stats.uploaded_bytes += staging.size() * sizeof(float);
+}
 
-        GLfloat xpos = tpos.axis.x + ch.bearing.x * scale->axis.x;
-        GLfloat ypos = tpos.axis.y - (ch.size.y - ch.bearing.y) * scale->axis.y;
+void text_batcher::render(text* const* texts, size_t count, const camera& cam) {
+    stats = text_stats();
+    for (size_t i = 0; i < count; i++)
+        stats.relayouts += texts[i]->update_layout();
 
-        GLfloat w = ch.size.x * scale->axis.x;
-        GLfloat h = ch.size.y * scale->axis.y;
-        // Update VBO for each character
-        GLfloat vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
+    // the texts that changed can be uploaded over their old vertices as long as nothing around them moved.
+    // Versions are unique, so a new text at a deleted one's address still gets uploaded.
+    bool regroup = count != input.size() || !std::equal(input.begin(), input.end(), texts);
+    for (size_t i = 0; i < sorted.size() && !regroup; i++) {
+        const text* ob = sorted[i];
+        regroup = sorted_keys[i] != std::make_pair(ob->font_data, ob->mat->data)
+            || sorted_counts[i] != ob->get_vertices().size() / TEXT_VERTEX_FLOATS;
+    }
+    if (regroup) {
+        rebuild(texts, count);
+    } else {
+        for (size_t i = 0; i < sorted.size(); i++) {
+            const text* ob = sorted[i];
+            if (sorted_versions[i] == ob->layout_version)
+                continue;
+            sorted_versions[i] = ob->layout_version;
+            const vector<float>& vertices = ob->get_vertices();
+            glBindBuffer(GL_ARRAY_BUFFER, buffer);
+            glBufferSubData(GL_ARRAY_BUFFER, sorted_firsts[i] * TEXT_VERTEX_FLOATS * sizeof(float), vertices.size() * sizeof(float), vertices.data());
+            stats.uploaded_bytes += vertices.size() * sizeof(float);
+        }
+    }
 
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }
-        };
+    for (const group& g : groups)
+        stats.glyphs += g.count / 6;
+    for (size_t i = 0; i < sorted.size(); i++)
+        stats.texts += sorted_counts[i] > 0;
+    if (groups.empty())
+        return;
 
-        // Render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.texture);
-        // Update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, font_data->vbo);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // Render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        // Now advance cursors for next glyph (advance is number of 1/64 pixels)
-        tpos.axis.x += (ch.advance >> 6) * scale->axis.x;
+    matrix4x4 projection(glm::ortho(0.0f, (float)cam.view_width, 0.0f, (float)cam.view_height));
+    glActiveTexture(GL_TEXTURE0);
+    for (const group& g : groups) {
+        g.mat->data->use_material();
+        // the color is in the vertices, text_color is there for materials that tint every text they draw.
+        g.mat->data->set_uniform("text_color", vec4(1.0f));
+        g.mat->data->set_uniform("projection", projection);
+        g.mat->data->register_uniforms();
+        glBindTexture(GL_TEXTURE_2D, g.font_data->atlas);
+        glBindVertexArray(g.font_data->vao);
+        g.font_data->bind_vertices(buffer);
+        glDrawArrays(GL_TRIANGLES, g.first, g.count);
+        stats.draws++;
     }
 
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <utility>
 
 #include "Vec2.h"
 #include "Vec3.h"
@@ -18,27 +19,37 @@ using std::string;
 using std::vector;
 
 struct character {
-    GLuint texture;  // ID handle of the glyph texture
-    glm::ivec2 size;   // Size of glyph
+    glm::vec4 uv;       // left, top, right and bottom of the glyph in the font's atlas
+    glm::ivec2 size;    // Size of glyph
     glm::ivec2 bearing; // Offset from baseline to left/top of glyph
-    GLuint advance;    // Offset to advance to next glyph
+    GLuint advance;     // Offset to advance to next glyph
 };
 
+// floats per text vertex: position xy, atlas uv and color rgba.
+#define TEXT_VERTEX_FLOATS 8
+
 class font {
 public:
     font() {}
     font(const string& font_path, int font_size);
 
+    // renders the ascii glyphs and packs them into one atlas texture, shelf by shelf from the tallest down.
     void init_font(FT_Face& face);
 
     void setup_buffers();
+    // points the vao's attributes at a batcher's vertex buffer.
+    void bind_vertices(GLuint buffer);
 
 friend class text;
+friend class text_batcher;
 private:
     
     character font_chars[128];
-    unsigned int vao, vbo;
-    int atlas_width, atlas_height;
+    unsigned int vao = 0;
+    // batchers never delete their buffers while drawing, so the name is enough to know the pointers are current.
+    GLuint bound_buffer = 0;
+    GLuint atlas = 0;
+    int atlas_width = 0, atlas_height = 0;
 };
 
 class text {
@@ -54,6 +65,7 @@ public:
         color(color)
     {}
 
+    // draws this text alone, the window draws its texts together. (see text_batcher)
     void render(camera& camera);
 
     inline matrix4x4 get_model_matrix() {
@@ -64,6 +76,19 @@ public:
         return model;
     }
 
+    // vertices write_vertices writes, 6 for every glyph with any pixels.
+    size_t vertex_count() const;
+    // writes the glyph quads in screen space, moved, rotated and scaled by the text's transform and colored by
+    // color.  TEXT_VERTEX_FLOATS per vertex, returns the vertices written.
+    size_t write_vertices(float* out) const;
+    // lays the text out into vertices again if its string, font, position, scale, rotation or color changed
+    // since the last layout.  Returns whether it did.
+    bool update_layout();
+    // the vertices of the last layout.
+    inline const vector<float>& get_vertices() const {
+        return vertices;
+    }
+
     string render_text;
     font* font_data;
     vec2* position;
@@ -72,4 +97,73 @@ public:
     vec4* color;
     rc_material mat;
     matrix4x4 model_matrix;
-};
\ No newline at end of file
+friend class text_batcher;
+private:
+    // what the last layout was made from.  Compared by value, the vectors can be changed in place from python.
+    struct layout_key {
+        string render_text;
+        font* font_data = nullptr;
+        GLuint atlas = 0; // fonts can be assigned over, the atlas tells them apart
+        glm::vec2 position = glm::vec2(0.0f), scale = glm::vec2(0.0f);
+        float rotation = 0.0f;
+        glm::vec4 color = glm::vec4(0.0f);
+    };
+    bool layout_matches() const;
+
+    bool has_layout = false;
+    layout_key laid_out;
+    vector<float> vertices;
+    // unique to each layout of any text, batchers compare it with the one they uploaded.
+    size_t layout_version = 0;
+    static size_t next_layout_version;
+};
+
+struct text_stats {
+    // texts and glyphs drawn in the last frame, and the draw calls they took.
+    size_t texts = 0;
+    size_t glyphs = 0;
+    size_t draws = 0;
+    // texts laid out again because they changed, and the bytes uploaded for them.
+    size_t relayouts = 0;
+    size_t uploaded_bytes = 0;
+};
+
+// Draws a list of texts with one draw call per font and material.  The texts are grouped so the ones sharing a
+// font and material are next to each other, their vertices are kept in one gpu buffer in that order and each
+// group is drawn from its font's atlas in one go.  Colors are per vertex, the material's text_color uniform is
+// left white.
+// The buffer stays on the gpu between frames: a text that changed is uploaded over its old vertices, and only a
+// change in the list, the grouping or a text's vertex count uploads everything again.  Unchanged text costs a
+// comparison of its layout inputs and its share of the draw.
+class text_batcher {
+public:
+    text_batcher() {}
+
+    text_batcher(const text_batcher&) = delete;
+    text_batcher& operator=(const text_batcher&) = delete;
+
+    // texts must stay alive untill the next render, the batcher keeps pointers to them.
+    void render(text* const* texts, size_t count, const camera& cam);
+
+    static inline text_stats get_stats() { return stats; }
+private:
+    struct group {
+        font* font_data;
+        rc_material mat;
+        GLint first;
+        GLsizei count;
+    };
+    // regroups the texts and uploads all of their vertices.
+    void rebuild(text* const* texts, size_t count);
+
+    vector<text*> input, sorted;
+    // for each sorted text: the font and material it was grouped by, its first vertex and vertex count in buffer,
+    // and the layout_version uploaded there.
+    vector<std::pair<font*, material*>> sorted_keys;
+    vector<size_t> sorted_firsts, sorted_counts, sorted_versions;
+    vector<group> groups;
+    vector<float> staging;
+    // not deleted with the batcher, the window's outlives its gl context.
+    GLuint buffer = 0;
+    static text_stats stats;
+};
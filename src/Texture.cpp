@@ -1,36 +1,136 @@
 #include "Texture.h"
+#include "ResourceCache.h"
+#include "TextureStreamer.h"
+#include <algorithm>
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 #include <sstream>
 #include <iostream>
 
-texture::texture(string file_path, TextureWraping wrap, TextureFiltering filtering){
-    this->file_path = file_path;
-    unsigned char * tex = stbi_load(file_path.c_str(), &width, &height, &number_of_channels, 0);
-    if (tex) {
-        glGenTextures(1, &gl_texture);
-        glBindTexture(GL_TEXTURE_2D, gl_texture);
-        
-        // texture settings:
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLint>(wrap));
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLint>(wrap));
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(filtering));
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(filtering));
-
-        int col_format = number_of_channels > 3 ? GL_RGBA : GL_RGB;
-
-        // texture data:
-        glTexImage2D(GL_TEXTURE_2D, 0, col_format, width, height, 0, col_format,
-            GL_UNSIGNED_BYTE, tex);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        stbi_image_free(tex);
-    } else {
+texture::texture(string file_path, TextureWraping wrap, TextureFiltering filtering, bool defer_upload) : file_path(file_path), wrap(wrap), filtering(filtering) {
+    string cooked_file = cooked_texture::find_cooked(file_path);
+    if (!cooked_file.empty()) {
+        try {
+            cooked = new cooked_texture(cooked_file);
+            cooked_path = cooked_file;
+            width = cooked->width;
+            height = cooked->height;
+            number_of_channels = cooked->format == CookedFormat::BC1 ? 3 : 4;
+            if (!defer_upload)
+                upload();
+            return;
+        } catch (std::runtime_error& e) {
+            // fall back to the source image.
+            std::cerr << e.what() << "\n";
+            if (file_path == cooked_file)
+                throw;
+        }
+    }
+    pixels = stbi_load(file_path.c_str(), &width, &height, &number_of_channels, 0);
+    if (!pixels) {
         std::stringstream ss;
         ss << "Failed to load texture at \"" << file_path << "\"\nSTBI log: " << stbi_failure_reason() << "\n\n  HINT: Could be missing \"textures\" folder?";
         throw std::runtime_error(ss.str());
     }
+    if (texture_streamer::is_enabled()) {
+        // the streamer re-uploads levels from a cpu side chain, build it here so a deferred load does it on the
+        // decoding thread instead of the gl one.  The decoded image isn't needed after that.
+        cooked = new cooked_texture(pixels, width, height, number_of_channels);
+        stbi_image_free(pixels);
+        pixels = nullptr;
+    }
+    if (!defer_upload)
+        upload();
+}
+
+texture::~texture() {
+    if (pixels)
+        stbi_image_free(pixels);
+    delete cooked;
+    if (stream_source) {
+        texture_streamer::remove(this);
+        delete stream_source;
+    }
+}
+
+void texture::apply_sampler_settings(int levels) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, static_cast<GLint>(wrap));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, static_cast<GLint>(wrap));
+    // the plain filters never read past level 0, so a chain needs the mipmapped variant to be sampled at all.
+    GLint min_filter = static_cast<GLint>(filtering);
+    if (levels > 1)
+        min_filter = filtering == TextureFiltering::NEAREST ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(filtering));
+}
+
+void texture::set_resident_level(int level) {
+    level = std::clamp(level, 0, mip_levels() - 1);
+    if (!stream_source || (gl_texture && level == resident_level))
+        return;
+    GLuint new_texture;
+    glGenTextures(1, &new_texture);
+    glBindTexture(GL_TEXTURE_2D, new_texture);
+    apply_sampler_settings(mip_levels() - level);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mip_levels() - 1 - level);
+    stream_source->upload_levels(GL_TEXTURE_2D, level);
+    if (gl_texture)
+        glDeleteTextures(1, &gl_texture);
+    gl_texture = new_texture;
+    resident_level = level;
+    resident_bytes = stream_source->byte_size(level);
+}
+
+void texture::upload() {
+    if (uploaded || (!pixels && !cooked))
+        return;
+
+    if (texture_streamer::is_enabled() && cooked) {
+        // keep the whole chain on the cpu and start small, the streamer raises it once it is drawn.  A texture
+        // that already fits in initial_size has nothing to stream and is uploaded whole like any other.
+        stream_source = cooked;
+        int level = texture_streamer::initial_level(this);
+        if (level > 0) {
+            cooked = nullptr;
+            resident_level = wanted_level = level;
+            set_resident_level(resident_level);
+            resource_cache::add_texture_bytes(resident_bytes);
+            texture_streamer::add(this);
+            uploaded = true;
+            return;
+        }
+        stream_source = nullptr;
+    }
+
+    glGenTextures(1, &gl_texture);
+    glBindTexture(GL_TEXTURE_2D, gl_texture);
+    
+    // texture settings, raw images get a generated chain below:
+    apply_sampler_settings(cooked ? static_cast<int>(cooked->levels.size()) : 2);
+
+    if (cooked) {
+        // every level is already in the file, upload them as is.
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(cooked->levels.size()) - 1);
+        cooked->upload_levels(GL_TEXTURE_2D);
+        resource_cache::add_texture_bytes(cooked->byte_size());
+        delete cooked;
+        cooked = nullptr;
+        uploaded = true;
+        return;
+    }
+
+    int col_format = number_of_channels > 3 ? GL_RGBA : GL_RGB;
+
+    // texture data:
+    glTexImage2D(GL_TEXTURE_2D, 0, col_format, width, height, 0, col_format,
+        GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    resource_cache::add_texture_bytes(static_cast<size_t>(width) * height * (number_of_channels > 3 ? 4 : 3) * 4 / 3);
+    stbi_image_free(pixels);
+    pixels = nullptr;
+    uploaded = true;
 }
 
 void texture::bind() {
     glBindTexture(GL_TEXTURE_2D, gl_texture);
-}
\ No newline at end of file
+}
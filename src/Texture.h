@@ -2,6 +2,7 @@
 #include <string>
 #include "glad/gl.h"
 #include <stdexcept>
+#include "CookedTexture.h"
 
 
 using std::string;
@@ -21,13 +22,45 @@ enum class TextureWraping {
 class texture {
 public:
     texture(){}
-    texture(string file_path, TextureWraping wrap, TextureFiltering filtering);
+    // when defer_upload is set the image is only decoded, call upload() on the gl thread afterwards.
+    // A cooked ".lxt" next to the image (see cooked_texture) is loaded instead of decoding it.  While texture_streamer
+    // is enabled a decoded image is turned into its mip chain here as well.
+    texture(string file_path, TextureWraping wrap, TextureFiltering filtering, bool defer_upload = false);
+    ~texture();
 
     void bind();
 
+    // uploads the decoded pixels to the gpu and frees them.  Must be called on the gl thread.
+    void upload();
+
     int width = 0, height = 0, number_of_channels = 0;
-    GLuint gl_texture;
+    GLuint gl_texture = 0;
     string file_path;
+    TextureWraping wrap = TextureWraping::REPEAT;
+    TextureFiltering filtering = TextureFiltering::LINEAR;
+    bool uploaded = false;
+    // the cooked file this texture was loaded from, empty when it was decoded from an image.
+    string cooked_path;
+
+    // streaming state, see texture_streamer.  Levels index the full mip chain, 0 being full resolution.
+    int resident_level = 0;
+    int wanted_level = 0;
+    size_t resident_bytes = 0;
+    uint64_t last_used_frame = 0;
+    float requested_px = 0.0f;
+    inline bool is_streamed() const { return stream_source != nullptr; }
+    inline const cooked_texture* get_stream_source() const { return stream_source; }
+    inline int mip_levels() const { return stream_source ? static_cast<int>(stream_source->levels.size()) : 1; }
+    // re-creates the gl texture holding only level and the levels below it.
+    void set_resident_level(int level);
+private:
+    // levels is the number of mip levels the gl texture holds.
+    void apply_sampler_settings(int levels);
+
+    unsigned char * pixels = nullptr;
+    cooked_texture* cooked = nullptr;
+    // the cpu side mip chain kept while the texture is streamed.
+    cooked_texture* stream_source = nullptr;
 };
 
 const int GL_TEX_N_ITTER[] = {
@@ -0,0 +1,138 @@
+#include "TextureStreamer.h"
+#include "Texture.h"
+#include "Camera.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+bool texture_streamer::enabled = false;
+size_t texture_streamer::budget_bytes = 512ull * 1024 * 1024;
+uint32_t texture_streamer::initial_size = 64;
+size_t texture_streamer::max_uploads_per_frame = 4;
+std::set<texture*> texture_streamer::textures;
+uint64_t texture_streamer::frame = 1;
+size_t texture_streamer::raises = 0;
+size_t texture_streamer::evictions = 0;
+
+void texture_streamer::add(texture* tex) {
+    textures.insert(tex);
+}
+
+void texture_streamer::remove(texture* tex) {
+    textures.erase(tex);
+}
+
+void texture_streamer::request(texture* tex, float screen_px) {
+    if (!tex->is_streamed())
+        return;
+    if (tex->last_used_frame != frame) {
+        tex->last_used_frame = frame;
+        tex->requested_px = 0.0f;
+    }
+    tex->requested_px = std::max(tex->requested_px, screen_px);
+}
+
+void texture_streamer::request_full(texture* tex) {
+    if (tex->is_streamed())
+        request(tex, static_cast<float>(std::max(tex->width, tex->height)));
+}
+
+float texture_streamer::screen_size(const camera& cam, const matrix4x4& model_matrix, const vec3& aabb_min, const vec3& aabb_max) {
+    return cam.screen_size(model_matrix, aabb_min, aabb_max);
+}
+
+int texture_streamer::initial_level(const texture* tex) {
+    const cooked_texture* source = tex->get_stream_source();
+    int level = 0;
+    while (level + 1 < static_cast<int>(source->levels.size())
+        && std::max(source->levels[level].width, source->levels[level].height) > initial_size)
+        level++;
+    return level;
+}
+
+int texture_streamer::level_for(const texture* tex, float screen_px) {
+    const cooked_texture* source = tex->get_stream_source();
+    float size = static_cast<float>(std::max(source->width, source->height));
+    int level = static_cast<int>(std::floor(std::log2(size / std::max(screen_px, 1.0f))));
+    return std::clamp(level, 0, static_cast<int>(source->levels.size()) - 1);
+}
+
+void texture_streamer::update() {
+    if (!enabled) {
+        frame++;
+        return;
+    }
+
+    size_t resident = 0;
+    for (texture* tex : textures) {
+        if (tex->last_used_frame == frame)
+            tex->wanted_level = level_for(tex, tex->requested_px);
+        resident += tex->resident_bytes;
+    }
+
+    // raise the textures that are largest on screen first, most recently used breaking ties.
+    std::vector<texture*> raise;
+    for (texture* tex : textures)
+        if (tex->wanted_level < tex->resident_level)
+            raise.push_back(tex);
+    std::sort(raise.begin(), raise.end(), [](texture* a, texture* b) {
+        if (a->last_used_frame != b->last_used_frame)
+            return a->last_used_frame > b->last_used_frame;
+        return a->requested_px > b->requested_px;
+    });
+    size_t uploads = 0;
+    for (texture* tex : raise) {
+        if (uploads >= max_uploads_per_frame)
+            break;
+        // the finest wanted level that still fits in the budget.
+        int level = tex->wanted_level;
+        while (level < tex->resident_level && resident - tex->resident_bytes + tex->get_stream_source()->byte_size(level) > budget_bytes)
+            level++;
+        if (level >= tex->resident_level)
+            continue;
+        resident -= tex->resident_bytes;
+        tex->set_resident_level(level);
+        resident += tex->resident_bytes;
+        raises++;
+        uploads++;
+    }
+
+    // over budget: drop the finest levels of the least recently used textures.
+    if (resident > budget_bytes) {
+        std::vector<texture*> lru(textures.begin(), textures.end());
+        std::sort(lru.begin(), lru.end(), [](texture* a, texture* b) {
+            return a->last_used_frame < b->last_used_frame;
+        });
+        for (texture* tex : lru) {
+            if (resident <= budget_bytes)
+                break;
+            int coarsest = static_cast<int>(tex->get_stream_source()->levels.size()) - 1;
+            int level = tex->resident_level;
+            while (level < coarsest && resident - tex->resident_bytes + tex->get_stream_source()->byte_size(level) > budget_bytes)
+                level++;
+            if (level == tex->resident_level)
+                continue;
+            resident -= tex->resident_bytes;
+            tex->set_resident_level(level);
+            resident += tex->resident_bytes;
+            evictions++;
+        }
+    }
+    frame++;
+}
+
+texture_stream_stats texture_streamer::get_stats() {
+    texture_stream_stats ret;
+    ret.budget_bytes = budget_bytes;
+    ret.textures = textures.size();
+    ret.raises = raises;
+    ret.evictions = evictions;
+    for (texture* tex : textures) {
+        ret.resident_bytes += tex->resident_bytes;
+        if (tex->resident_level == 0)
+            ret.fully_resident++;
+        if (tex->wanted_level < tex->resident_level)
+            ret.pending++;
+    }
+    return ret;
+}
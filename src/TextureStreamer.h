@@ -0,0 +1,67 @@
+#pragma once
+#include <set>
+#include <cstdint>
+#include <cstddef>
+#include "glad/gl.h"
+#include "Matrix.h"
+#include "Vec3.h"
+
+class texture;
+class camera;
+
+struct texture_stream_stats {
+    size_t budget_bytes = 0;
+    size_t resident_bytes = 0;
+    size_t textures = 0;
+    // textures with their full resolution level in vram.
+    size_t fully_resident = 0;
+    // textures that want a finer level than they have.
+    size_t pending = 0;
+    size_t raises = 0;
+    size_t evictions = 0;
+};
+
+// Streams texture mip levels in and out of vram under a byte budget.
+// Streamed textures keep their whole mip chain on the cpu (a mapped cooked file, or a chain built from the decoded
+// image) and are first uploaded at a small size.  Every frame the renderer reports how many pixels each mesh covers
+// on screen for the textures it binds, and the streamer raises those textures to the level that matches, largest on
+// screen first.  Textures nothing has drawn yet stay at the level they started at.  When the budget is exceeded the
+// least recently drawn textures drop their finest levels.
+// A level change re-creates the gl texture with the levels that are now resident, so bound handles stay valid
+// untill the next bind().  Gl thread only.
+
+class texture_streamer {
+public:
+    static bool enabled;
+    static inline void set_enabled(bool value) { enabled = value; }
+    static inline bool is_enabled() { return enabled; }
+
+    static size_t budget_bytes;
+    static inline void set_budget(size_t bytes) { budget_bytes = bytes; }
+    static inline size_t get_budget() { return budget_bytes; }
+
+    // new textures are uploaded from the first level no larger than this on either side.
+    static uint32_t initial_size;
+    // level changes (each one a re-upload) made per frame when raising.  Evictions are not limited.
+    static size_t max_uploads_per_frame;
+
+    static void add(texture* tex);
+    static void remove(texture* tex);
+    // records that tex is drawn this frame covering about screen_px pixels across.
+    static void request(texture* tex, float screen_px);
+    // records that tex is drawn this frame at a size that isn't tracked (sprites, particles), it wants full resolution.
+    static void request_full(texture* tex);
+    // projected diameter in pixels of the aabb (in model space) drawn with model_matrix.
+    static float screen_size(const camera& cam, const matrix4x4& model_matrix, const vec3& aabb_min, const vec3& aabb_max);
+    // applies the frame's requests, called once per frame by the window.
+    static void update();
+    // the level a texture starts at, see initial_size.
+    static int initial_level(const texture* tex);
+
+    static texture_stream_stats get_stats();
+private:
+    static int level_for(const texture* tex, float screen_px);
+    static std::set<texture*> textures;
+    static uint64_t frame;
+    static size_t raises, evictions;
+};
@@ -0,0 +1,105 @@
+#include "ThreadPool.h"
+#include <atomic>
+#include <algorithm>
+#include <exception>
+
+thread_pool::thread_pool(size_t thread_count) {
+    if (thread_count == 0) {
+        // leave one core for the thread that owns the gl context.
+        size_t hw = std::thread::hardware_concurrency();
+        thread_count = hw > 1 ? hw - 1 : 1;
+    }
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; i++)
+        workers.emplace_back(&thread_pool::worker_loop, this);
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    job_ready.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void thread_pool::worker_loop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            job_ready.wait(guard, [this] { return stopping || !jobs.empty(); });
+            if (stopping && jobs.empty())
+                return;
+            job = std::move(jobs.front());
+            jobs.pop();
+        }
+        job();
+    }
+}
+
+void thread_pool::parallel_for(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0)
+        return;
+    if (count == 1) {
+        body(0);
+        return;
+    }
+
+    // helpers may only be scheduled after every index is claimed, so the state they touch is shared
+    // and body is only dereferenced after a successful claim, which always happens before we return.
+    struct for_state {
+        std::atomic<size_t> next = 0;
+        size_t count = 0;
+        size_t done = 0;
+        const std::function<void(size_t)>* body = nullptr;
+        std::exception_ptr error;
+        std::mutex lock;
+        std::condition_variable finished;
+    };
+    auto state = std::make_shared<for_state>();
+    state->count = count;
+    state->body = &body;
+
+    auto work = [state]() {
+        size_t ran = 0;
+        std::exception_ptr error;
+        for (size_t i = state->next++; i < state->count; i = state->next++) {
+            try {
+                (*state->body)(i);
+            } catch (...) {
+                if (!error)
+                    error = std::current_exception();
+            }
+            ran++;
+        }
+        if (ran == 0)
+            return;
+        std::lock_guard<std::mutex> guard(state->lock);
+        if (error && !state->error)
+            state->error = error;
+        state->done += ran;
+        if (state->done == state->count)
+            state->finished.notify_all();
+    };
+
+    size_t helpers = std::min(workers.size(), count - 1);
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        for (size_t i = 0; i < helpers; i++)
+            jobs.push(work);
+    }
+    job_ready.notify_all();
+
+    work();
+    std::unique_lock<std::mutex> guard(state->lock);
+    state->finished.wait(guard, [&state] { return state->done == state->count; });
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
+thread_pool* thread_pool::get_global() {
+    static thread_pool global_pool;
+    return &global_pool;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+using std::vector;
+
+// Fixed size pool of worker threads used for any engine work that does not touch OpenGL.
+// (asset imports, texture decoding etc.)  GL work must stay on the thread that owns the context.
+
+class thread_pool {
+public:
+    thread_pool(size_t thread_count = 0);
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Queues a job and returns a future for its result.  Exceptions thrown by the job are rethrown by future.get().
+    template<typename F>
+    inline auto submit(F&& job) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using ret_type = std::invoke_result_t<std::decay_t<F>>;
+        auto task = std::make_shared<std::packaged_task<ret_type()>>(std::forward<F>(job));
+        std::future<ret_type> ret = task->get_future();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            jobs.push([task]() { (*task)(); });
+        }
+        job_ready.notify_one();
+        return ret;
+    }
+
+    // Calls body(i) for every i in [0, count) across the pool and blocks untill all calls have returned.
+    // The calling thread works through indices too, so this is safe to call from inside a pool job.
+    // The first exception thrown by body is rethrown once every index has been processed.
+    void parallel_for(size_t count, const std::function<void(size_t)>& body);
+
+    inline size_t size() const {
+        return workers.size();
+    }
+
+    // The pool shared by the whole engine, created on first use.
+    static thread_pool* get_global();
+private:
+    void worker_loop();
+
+    vector<std::thread> workers;
+    std::queue<std::function<void()>> jobs;
+    std::mutex lock;
+    std::condition_variable job_ready;
+    bool stopping = false;
+};
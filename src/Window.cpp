@@ -10,6 +10,14 @@
 #include "Mesh.h"
 #include "Model.h"
 #include "Animation.h"
+#include "AsyncLoader.h"
+#include "TextureStreamer.h"
+#include "ThreadPool.h"
+#include "AnimationLod.h"
+#include "StreamBuffer.h"
+#include "ParticleProfiler.h"
+#include "ParticleLod.h"
+#include <algorithm>
 
 #define in_set(the_set, item) the_set.find(item) != the_set.end()
 
@@ -110,6 +118,138 @@ void window::create_window() {
 
 
 
+void window::animate_objects() {
+    animated_objects.clear();
+    for (object3d* ob : render_list) {
+        model* data = ob->model_data->data;
+        if (!data->loaded || !data->animated)
+            continue;
+        if (!data->bounds_ready)
+            data->calculate_bounds();
+        animated_objects.push_back(ob);
+    }
+    if (animated_objects.empty()) {
+        animation_lod::record_frame(animated_objects);
+        return;
+    }
+
+    float dt = static_cast<float>(this->deltatime);
+    const camera& cam = *this->cam;
+    thread_pool* pool = thread_pool::get_global();
+    if (!parallel_animation || animated_objects.size() < 2 || pool->size() == 0) {
+        for (object3d* ob : animated_objects) {
+            animation_lod::apply(ob, cam);
+            ob->update_animation(dt);
+        }
+        animation_lod::record_frame(animated_objects);
+        return;
+    }
+
+    // a few chunks per thread keeps the load even when skeletons differ in size
+    // without paying the hand off cost for every object in large crowds.
+    size_t chunk = std::max<size_t>(1, animated_objects.size() / ((pool->size() + 1) * 4));
+    size_t chunks = (animated_objects.size() + chunk - 1) / chunk;
+    pool->parallel_for(chunks, [&](size_t c) {
+        size_t end = std::min(animated_objects.size(), (c + 1) * chunk);
+        for (size_t i = c * chunk; i < end; i++) {
+            animation_lod::apply(animated_objects[i], cam);
+            animated_objects[i]->update_animation(dt);
+        }
+    });
+    animation_lod::record_frame(animated_objects);
+}
+
+void window::simulate_emitters() {
+    particle_emitters.clear();
+    simulated_emitters.clear();
+    drawn_emitters.clear();
+    particle_jobs.clear();
+    float dt = static_cast<float>(this->deltatime);
+    const camera& cam = *this->cam;
+    bool grid_built = false;
+    for (emitter* ob : render_list_emitter) {
+        ob->prepare_simulation();
+        if (!ob->emitting || ob->particles.size() == 0)
+            continue;
+        particle_emitters.push_back(ob);
+        particle_lod::apply(ob, cam, dt);
+        if (!ob->step)
+            continue;
+        if (ob->collides()) {
+            if (ob->collide_colliders && !grid_built) {
+                collider_grid.build(render_list);
+                grid_built = true;
+            }
+            ob->gather_colliders(ob->collide_colliders ? &collider_grid : nullptr);
+        }
+        for (size_t c = 0; c < ob->chunk_count(); c++)
+            particle_jobs.emplace_back(simulated_emitters.size(), c);
+        simulated_emitters.push_back(ob);
+    }
+    if (simulated_emitters.empty()) {
+        particle_profiler::record_frame(particle_emitters);
+        return;
+    }
+
+    thread_pool* pool = thread_pool::get_global();
+    bool parallel = parallel_particles && pool->size() > 0 && particle_jobs.size() > 1;
+    auto for_each = [&](size_t count, const std::function<void(size_t)>& body) {
+        if (parallel) {
+            pool->parallel_for(count, body);
+        } else {
+            for (size_t i = 0; i < count; i++)
+                body(i);
+        }
+    };
+
+    for_each(particle_jobs.size(), [&](size_t j) {
+        emitter* ob = simulated_emitters[particle_jobs[j].first];
+        ob->simulate_chunk(particle_jobs[j].second, ob->step_dt);
+    });
+    const glm::mat4& view = cam.view.mat;
+    for_each(simulated_emitters.size(), [&](size_t e) {
+        emitter* ob = simulated_emitters[e];
+        ob->finish_simulation();
+        if (ob->depth_sort && ob->visible)
+            ob->sort_particles(view);
+    });
+
+    // one streaming range for every emitter that is drawn (the unsynchronized path can only map one range of a
+    // buffer at a time), each job copies its chunk into the emitter's slice of it.
+    const size_t stride = PARTICLE_INSTANCE_FLOATS * sizeof(float);
+    size_t total = 0;
+    for (emitter* ob : simulated_emitters) {
+        if (!ob->visible)
+            continue;
+        total += ob->active;
+        drawn_emitters.push_back(ob);
+    }
+    if (!drawn_emitters.empty()) {
+        stream_buffer* stream = stream_buffer::get_global();
+        stream_range range = stream->allocate(total * stride, stride);
+        size_t first = 0;
+        for (emitter* ob : drawn_emitters) {
+            ob->instances = range;
+            ob->instances.offset = range.offset + first * stride;
+            ob->instances.size = ob->active * stride;
+            ob->instances.data = static_cast<char*>(range.data) + first * stride;
+            first += ob->active;
+        }
+        for_each(particle_jobs.size(), [&](size_t j) {
+            emitter* ob = simulated_emitters[particle_jobs[j].first];
+            if (ob->visible)
+                ob->write_chunk(particle_jobs[j].second, static_cast<float*>(ob->instances.data));
+        });
+        stream->commit(range);
+    }
+    particle_profiler::record_frame(particle_emitters);
+
+    // emitters are drawn back to front too, by their origins, so overlapping effects blend in the right order.
+    std::stable_sort(drawn_emitters.begin(), drawn_emitters.end(), [&](const emitter* a, const emitter* b) {
+        return (view * glm::vec4(a->position->axis, 1.0f)).z < (view * glm::vec4(b->position->axis, 1.0f)).z;
+    });
+}
+
 void window::update() {
     this->new_time = std::chrono::steady_clock::now();
     this->time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(this->starttime - this->old_time).count();
@@ -119,12 +259,17 @@ void window::update() {
     this->current_event.handle_events(this);
 
     this->cam->recalculate_pv();
+
+    // finish gl work for assets loaded in the background
+    gl_upload_queue::drain(this->upload_budget);
     
+    // every pose is evaluated before rendering starts, rendering only uploads the palettes.
+    this->animate_objects();
+    this->simulate_emitters();
+
     for (object3d* ob : render_list) {
-        // update animations
-        if (ob->model_data->data->animated) {
-            ob->model_data->data->animation_player->update(deltatime);
-        }
+        if (!ob->model_data->data->loaded)
+            continue;
 
         ob->render(*this->cam, this);
         
@@ -136,12 +281,13 @@ void window::update() {
             }
         }
 
-        if (ob->model_data->data->animated)
-            ob->model_data->data->animation_player->render_debug(this->cam, ob->model_matrix);
+        if (ob->model_data->data->animated && ob->animation_player)
+            ob->animation_player->render_debug(this->cam, ob->model_matrix);
     }
     
     glDepthMask(GL_FALSE);// TODO Make this per sprite based on wether the sprite is marked as translucent
-    for (emitter* ob : render_list_emitter) {
+    // simulate_emitters left the emitters that are in view back to front.
+    for (emitter* ob : drawn_emitters) {
         ob->render(*this->cam);
     }
 
@@ -156,12 +302,19 @@ void window::update() {
     }
 
     // text (TODO: make sprites and text part of the same set so they can be layered. (probably via a variant))
-    for (text* ob : render_list_text) {
-        ob->render(*this->cam);
-    }
+    // one draw per font and material.
+    texts.assign(render_list_text.begin(), render_list_text.end());
+    text_batch.render(texts.data(), texts.size(), *this->cam);
     glDepthMask(GL_TRUE);// TODO Make this per sprite based on wether the sprite is marked as translucent
  
     SDL_GL_SwapWindow(this->app_window);
+
+    // fence this frame's streamed vertex data and move on to the next region
+    stream_buffer::get_global()->end_frame();
+
+    // stream texture mips for what was drawn this frame
+    texture_streamer::update();
+
     glClear(GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
     
     glDepthMask(GL_FALSE);
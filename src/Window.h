@@ -41,6 +41,12 @@ public:
     void update();
     double deltatime = 1.0f;
     long long time_ns = 1, time = 1;
+    // milliseconds per frame spent creating gl objects for models loaded in the background.
+    double upload_budget = 2.0;
+    // evaluate animation poses on the engine thread pool before rendering.
+    bool parallel_animation = true;
+    // simulate particles on the engine thread pool before rendering.
+    bool parallel_particles = true;
 
     inline void lock_mouse(bool lock) {
         SDL_SetRelativeMouseMode(SDLBOOL(lock));
@@ -96,6 +102,18 @@ public:
     audio_mixer* sound_mixer;
 private:
     void create_window();
+    void animate_objects();
+    vector<object3d*> animated_objects;
+    // advances every emitting emitter and streams their instance data, before anything is drawn.
+    void simulate_emitters();
+    // emitting this frame, simulated this frame (see particle_lod) and in view, back to front.
+    vector<emitter*> particle_emitters, simulated_emitters, drawn_emitters;
+    // (emitter index, chunk) of every simulation job this frame.
+    vector<std::pair<size_t, size_t>> particle_jobs;
+    // the objects' box colliders, for emitters that collide with them.
+    particle_collider_grid collider_grid;
+    vector<text*> texts;
+    text_batcher text_batch;
     SDL_Window* app_window = nullptr;
     SDL_Renderer* renderer = nullptr;
     SDL_Texture* texture = nullptr;
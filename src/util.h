@@ -49,13 +49,6 @@ inline void ogl_err_print() {
   }
 }
 
-inline float rand_range(float low, float high) {
-    float random = ((float) rand()) / (float) RAND_MAX;
-    float diff = high - low;
-    float r = random * diff;
-    return low + r;
-}
-
 static std::string MOD_PATH;
 
 void c_set_mod_path(std::string path);